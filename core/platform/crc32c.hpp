@@ -0,0 +1,67 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// crc32c.hpp - CRC32C (Castagnoli) para Registros Persistentes
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Checksum dos registros gravados em arquivo (RingBuffer em modo
+// de recuperacao). Com SSE4.2 (-march=westmere em diante) usa a
+// instrucao crc32, 8 bytes por instrucao; sem ela, tabela de 256
+// entradas, 1 byte por passo. Os dois caminhos dao o mesmo valor.
+//
+// ALGORITMO: Divisao Polinomial em GF(2)
+// BASE TEORICA: Cormen Cap.31 - Algoritmos de Teoria dos Numeros
+// O CRC e o resto da divisao da mensagem pelo polinomio
+// 0x1EDC6F41 (refletido: 0x82F63B78) em aritmetica modulo 2.
+//
+// Complexidade: O(n)
+// ================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if defined(__SSE4_2__)
+    #include <nmmintrin.h>
+#endif
+
+namespace petronilho::platform {
+
+    namespace detail {
+        struct Crc32cTable {
+            uint32_t v[256];
+            constexpr Crc32cTable() noexcept : v{} {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                        c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+                    v[i] = c;
+                }
+            }
+        };
+        inline constexpr Crc32cTable CRC32C_TABLE{};
+    }
+
+    // Continua um CRC: crc32c(b, nb, crc32c(a, na)) == crc32c(a+b)
+    [[nodiscard]]
+    inline uint32_t crc32c(const void* data, size_t len, uint32_t crc = 0) noexcept {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+    #if defined(__SSE4_2__)
+        uint64_t c = crc;
+        for (; len >= 8; p += 8, len -= 8) {
+            uint64_t w;
+            std::memcpy(&w, p, 8);
+            c = _mm_crc32_u64(c, w);
+        }
+        crc = static_cast<uint32_t>(c);
+        for (; len; ++p, --len) crc = _mm_crc32_u8(crc, *p);
+    #else
+        for (; len; ++p, --len)
+            crc = detail::CRC32C_TABLE.v[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    #endif
+        return ~crc;
+    }
+
+} // namespace petronilho::platform
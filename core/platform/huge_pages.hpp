@@ -0,0 +1,247 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// huge_pages.hpp - Mapeamentos com Paginas Grandes
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Arenas e aneis de varios GB em paginas de 4KB estouram a TLB:
+// cada entrada cobre 4KB e um acesso aleatorio quase sempre erra.
+// Com 2MB cada entrada cobre 512x mais; com 1GB, 262144x.
+// Este arquivo mapeia memoria tentando, em ordem:
+//
+//   anonimo (arenas):
+//     1. MAP_HUGETLB | MAP_HUGE_1GB  (tamanho >= 1GB)
+//     2. MAP_HUGETLB | MAP_HUGE_2MB
+//     3. 4KB alinhado a 2MB + madvise(MADV_HUGEPAGE) (THP)
+//     4. 4KB
+//   arquivo (RingBuffer, PersistentArena):
+//     hugetlbfs: paginas do proprio fs (2MB/1GB)
+//     outros:    madvise(MADV_HUGEPAGE) (THP em tmpfs/shmem
+//                montado com huge=advise); senao 4KB
+//
+// MAP_HUGETLB reserva as paginas no mmap: sem paginas livres em
+// /proc/sys/vm/nr_hugepages o mmap falha e o proximo nivel e
+// tentado. THP e um pedido: thp_backed_bytes() le /proc/self/smaps
+// e diz quanto o kernel realmente entregou em 2MB.
+//
+// ALGORITMO: Cadeia de Tentativas (fallback)
+// BASE TEORICA: Cormen Cap.11 - Tabelas Hash / Enderecamento
+// A TLB e uma cache associativa de traducoes; paginas maiores
+// aumentam a memoria coberta pelo mesmo numero de entradas.
+//
+// Complexidade: O(1) syscalls; populate O(bytes / pagina)
+// ================================================================
+
+#pragma once
+#include "platform_detect.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGE_SHIFT
+    #define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+    #define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+    #define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+#ifndef HUGETLBFS_MAGIC
+    #define HUGETLBFS_MAGIC 0x958458f6
+#endif
+
+namespace petronilho::platform {
+
+    static constexpr size_t PAGE_4K = 4096;
+    static constexpr size_t PAGE_2M = 2ULL << 20;
+    static constexpr size_t PAGE_1G = 1ULL << 30;
+
+    // SMALL: 4KB direto (comportamento anterior)
+    // HUGE : tenta a cadeia acima
+    enum class PageHint : uint8_t { SMALL, HUGE };
+
+    // Pagina obtida. THP: madvise aceito; com populate, confirmado
+    // em smaps (senao vira SMALL_4K)
+    enum class PageSize : uint8_t { SMALL_4K, THP, HUGE_2M, HUGE_1G };
+
+    [[nodiscard]]
+    inline const char* page_size_name(PageSize p) noexcept {
+        switch (p) {
+            case PageSize::HUGE_1G: return "1GB (hugetlb)";
+            case PageSize::HUGE_2M: return "2MB (hugetlb)";
+            case PageSize::THP:     return "THP (madvise)";
+            default:                return "4KB";
+        }
+    }
+
+    struct PageMapping {
+        void*    ptr   = nullptr;
+        size_t   bytes = 0;   // tamanho mapeado (arredondado a pagina)
+        PageSize page  = PageSize::SMALL_4K;
+
+        [[nodiscard]]
+        bool ok() const noexcept { return ptr != nullptr; }
+    };
+
+    namespace detail {
+        inline size_t round_up(size_t v, size_t a) noexcept {
+            return (v + a - 1) & ~(a - 1);
+        }
+
+        // Um acesso por pagina: faz o kernel alocar agora (e, com THP,
+        // em paginas de 2MB) e nao no caminho quente. Arquivo: so
+        // leitura, o conteudo nao pode mudar.
+        inline void touch(void* p, size_t bytes, bool write) noexcept {
+            volatile uint8_t* b = static_cast<uint8_t*>(p);
+            if (write) for (size_t off = 0; off < bytes; off += PAGE_4K) b[off] = 0;
+            else       for (size_t off = 0; off < bytes; off += PAGE_4K) (void)b[off];
+        }
+
+        inline void* try_hugetlb(size_t bytes, int size_flag, bool populate) noexcept {
+            const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | size_flag
+                            | (populate ? MAP_POPULATE : 0);
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+    }
+
+    // ============================================================
+    // thp_backed_bytes - quanto do mapeamento em p o kernel
+    // colocou em paginas de 2MB (AnonHugePages, ShmemPmdMapped,
+    // FilePmdMapped da VMA em /proc/self/smaps). Diagnostico, nao
+    // use no caminho quente.
+    // ============================================================
+    [[nodiscard]]
+    inline size_t thp_backed_bytes(const void* p) noexcept {
+        FILE* f = std::fopen("/proc/self/smaps", "r");
+        if (!f) return 0;
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+        char   line[256];
+        bool   in_vma = false;
+        size_t kb_total = 0;
+        while (std::fgets(line, sizeof(line), f)) {
+            unsigned long lo, hi;
+            // Cabecalho de VMA: "inicio-fim perms ..."
+            if (std::sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {
+                if (in_vma) break;
+                in_vma = addr >= lo && addr < hi;
+                continue;
+            }
+            if (!in_vma) continue;
+            size_t kb;
+            if (std::sscanf(line, "AnonHugePages: %zu kB", &kb) == 1
+                || std::sscanf(line, "ShmemPmdMapped: %zu kB", &kb) == 1
+                || std::sscanf(line, "FilePmdMapped: %zu kB", &kb) == 1)
+                kb_total += kb;
+        }
+        std::fclose(f);
+        return kb_total * 1024;
+    }
+
+    // ============================================================
+    // map_anonymous - memoria anonima para arenas
+    // populate: todas as paginas alocadas antes de retornar
+    // ============================================================
+    [[nodiscard]]
+    inline PageMapping map_anonymous(size_t bytes, PageHint hint,
+                                     bool populate = true) noexcept {
+        PageMapping m;
+        if (bytes == 0) return m;
+
+        if (hint == PageHint::HUGE) {
+            if (bytes >= PAGE_1G) {
+                const size_t len = detail::round_up(bytes, PAGE_1G);
+                if (void* p = detail::try_hugetlb(len, MAP_HUGE_1GB, populate))
+                    return PageMapping{ p, len, PageSize::HUGE_1G };
+            }
+            const size_t len = detail::round_up(bytes, PAGE_2M);
+            if (void* p = detail::try_hugetlb(len, MAP_HUGE_2MB, populate))
+                return PageMapping{ p, len, PageSize::HUGE_2M };
+
+            // THP: so regioes alinhadas a 2MB viram paginas de 2MB.
+            // Mapeia 2MB a mais e corta o excesso das pontas.
+            void* raw = mmap(nullptr, len + PAGE_2M, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw != MAP_FAILED) {
+                const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+                const uintptr_t al    = detail::round_up(start, PAGE_2M);
+                if (al > start) munmap(raw, al - start);
+                const size_t tail = (start + len + PAGE_2M) - (al + len);
+                if (tail) munmap(reinterpret_cast<void*>(al + len), tail);
+
+                m.ptr   = reinterpret_cast<void*>(al);
+                m.bytes = len;
+                m.page  = madvise(m.ptr, len, MADV_HUGEPAGE) == 0
+                        ? PageSize::THP : PageSize::SMALL_4K;
+                if (populate) {
+                    detail::touch(m.ptr, len, true);
+                    if (thp_backed_bytes(m.ptr) == 0) m.page = PageSize::SMALL_4K;
+                }
+                return m;
+            }
+        }
+
+        const size_t len = detail::round_up(bytes, PAGE_4K);
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | (populate ? MAP_POPULATE : 0), -1, 0);
+        if (p == MAP_FAILED) return m;
+        return PageMapping{ p, len, PageSize::SMALL_4K };
+    }
+
+    // Granularidade de mapeamento do fs do arquivo: tamanho da pagina
+    // grande em hugetlbfs, 4KB nos outros
+    [[nodiscard]]
+    inline size_t file_page_size(int fd) noexcept {
+        struct statfs fs;
+        if (fstatfs(fd, &fs) == 0 && (uint32_t)fs.f_type == (uint32_t)HUGETLBFS_MAGIC)
+            return static_cast<size_t>(fs.f_bsize);
+        return PAGE_4K;
+    }
+
+    // ============================================================
+    // map_file - MAP_SHARED de um arquivo ja dimensionado
+    // Em hugetlbfs o arquivo precisa ter bytes arredondado a
+    // file_page_size(fd); o chamador dimensiona com esse valor.
+    // THP: madvise antes de popular, senao as paginas ja entram
+    // em 4KB.
+    // ============================================================
+    [[nodiscard]]
+    inline PageMapping map_file(int fd, size_t bytes, int prot, PageHint hint,
+                                bool populate = false) noexcept {
+        PageMapping m;
+        const size_t page = file_page_size(fd);
+        const size_t len  = detail::round_up(bytes, page);
+        const bool   thp  = hint == PageHint::HUGE && page == PAGE_4K;
+        void* p = mmap(nullptr, len, prot,
+                       MAP_SHARED | (populate && !thp ? MAP_POPULATE : 0), fd, 0);
+        if (p == MAP_FAILED) return m;
+
+        m.ptr   = p;
+        m.bytes = len;
+        if (page >= PAGE_1G)      m.page = PageSize::HUGE_1G;
+        else if (page >= PAGE_2M) m.page = PageSize::HUGE_2M;
+        else if (thp && madvise(p, len, MADV_HUGEPAGE) == 0) {
+            m.page = PageSize::THP;
+            if (populate) {
+                detail::touch(p, len, false);
+                if (thp_backed_bytes(p) == 0) m.page = PageSize::SMALL_4K;
+            }
+        } else if (thp && populate) {
+            detail::touch(p, len, false);
+        }
+        return m;
+    }
+
+    inline void unmap(PageMapping& m) noexcept {
+        if (m.ptr) munmap(m.ptr, m.bytes);
+        m = PageMapping{};
+    }
+
+} // namespace petronilho::platform
@@ -0,0 +1,246 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// numa.hpp - Topologia NUMA e Memoria Local ao No
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Em servidores de dois soquetes cada soquete tem sua memoria;
+// acessar a do outro custa ~1.5-2x em latencia e divide a banda
+// do link entre soquetes. O Linux coloca a pagina no no da
+// thread que a toca primeiro (first-touch): um buffer zerado
+// pela thread principal fica inteiro num no, e metade das
+// threads de recepcao passa a escrever em memoria remota.
+//
+//   numa_topology() : nos e CPUs lidos de /sys/devices/system/node
+//                     (uma vez por processo). Sem sysfs: 1 no.
+//                     Ids de no podem ter buracos (0,2): nodes conta
+//                     so os online; node_index() mapeia id -> 0..n-1
+//   current_node()  : no da CPU em que a thread roda (getcpu)
+//   bind_to_node()  : mbind(MPOL_PREFERRED) de um intervalo; com
+//                     move, migra as paginas ja tocadas
+//   map_on_node()   : map_anonymous + mbind antes do primeiro
+//                     toque: as paginas ja nascem no no
+//   NodeLocal<T>    : objeto (ex.: NetworkQueue) construido numa
+//                     regiao propria, local ao no
+//
+// MPOL_PREFERRED, nao MPOL_BIND: no cheio cai para outro no em
+// vez de falhar a alocacao (SIGBUS no primeiro toque). Host de
+// um no so: tudo vira no-op e devolve sucesso. Sem libnuma: as
+// syscalls sao chamadas direto.
+//
+// ALGORITMO: Particionamento de Memoria por Localidade
+// BASE TEORICA: Cormen Cap.27 - Multithreaded Algorithms
+// O custo de um algoritmo paralelo inclui o acesso a memoria;
+// particionar os dados pelo processador que os usa transforma
+// acessos remotos em locais, como na hierarquia de cache.
+//
+// Complexidade: topologia O(CPUs) uma vez; bind O(1) syscalls
+// (+ O(paginas) com move)
+// ================================================================
+
+#pragma once
+#include "platform_detect.hpp"
+#include "huge_pages.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MPOL_PREFERRED
+    #define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_MF_MOVE
+    #define MPOL_MF_MOVE (1 << 1)
+#endif
+
+namespace petronilho::platform {
+
+    static constexpr uint32_t NUMA_MAX_NODES = 64;
+    static constexpr uint32_t NUMA_MAX_CPUS  = 1024;
+
+    struct NumaTopology {
+        uint32_t nodes;                      // nos online (>= 1)
+        int16_t  node_id[NUMA_MAX_NODES];    // indice -> id do no
+        int16_t  node_index[NUMA_MAX_NODES]; // id -> indice; -1 offline
+        int16_t  cpu_node[NUMA_MAX_CPUS];    // -1: CPU desconhecida
+
+        [[nodiscard]]
+        bool multi_node() const noexcept { return nodes > 1; }
+    };
+
+    namespace detail {
+        // Le uma lista do sysfs ("0-3,8-11") e chama f(i) para cada i
+        template<typename F>
+        inline bool for_each_in_list(const char* path, F&& f) noexcept {
+            FILE* fp = std::fopen(path, "r");
+            if (!fp) return false;
+            char buf[4096];
+            const bool ok = std::fgets(buf, sizeof(buf), fp) != nullptr;
+            std::fclose(fp);
+            if (!ok) return false;
+            for (char* p = buf; *p && *p != '\n';) {
+                char* end;
+                const long lo = std::strtol(p, &end, 10);
+                if (end == p) break;
+                long hi = lo;
+                p = end;
+                if (*p == '-') { hi = std::strtol(p + 1, &end, 10); p = end; }
+                for (long i = lo; i <= hi; ++i) f(i);
+                if (*p == ',') ++p;
+            }
+            return true;
+        }
+
+        inline NumaTopology read_topology() noexcept {
+            NumaTopology t{};
+            t.nodes = 0;
+            for (uint32_t c = 0; c < NUMA_MAX_CPUS; ++c) t.cpu_node[c] = -1;
+            for (uint32_t n = 0; n < NUMA_MAX_NODES; ++n) t.node_id[n] = t.node_index[n] = -1;
+
+            // Conta so os ids listados: "0,2" sao 2 nos, nao 3
+            const bool found = for_each_in_list("/sys/devices/system/node/online", [&](long n) {
+                if (n < 0 || n >= (long)NUMA_MAX_NODES || t.node_index[n] >= 0) return;
+                t.node_index[n]      = (int16_t)t.nodes;
+                t.node_id[t.nodes++] = (int16_t)n;
+                char path[96];
+                std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%ld/cpulist", n);
+                (void)for_each_in_list(path, [&](long cpu) {
+                    if (cpu >= 0 && cpu < (long)NUMA_MAX_CPUS) t.cpu_node[cpu] = (int16_t)n;
+                });
+            });
+            if (!found || t.nodes == 0) {
+                t.nodes = 1;
+                t.node_id[0] = t.node_index[0] = 0;
+            }
+            return t;
+        }
+    }
+
+    [[nodiscard]]
+    inline const NumaTopology& numa_topology() noexcept {
+        static const NumaTopology topo = detail::read_topology();
+        return topo;
+    }
+
+    [[nodiscard]]
+    inline uint32_t numa_nodes() noexcept { return numa_topology().nodes; }
+
+    // Indice 0..nodes-1 do no com esse id; -1 se offline/invalido
+    [[nodiscard]]
+    inline int node_index(int node) noexcept {
+        if (node < 0 || node >= (int)NUMA_MAX_NODES) return -1;
+        return numa_topology().node_index[node];
+    }
+
+    // No da CPU; 0 se desconhecida
+    [[nodiscard]]
+    inline int node_of_cpu(int cpu) noexcept {
+        if (cpu < 0 || cpu >= (int)NUMA_MAX_CPUS) return 0;
+        const int n = numa_topology().cpu_node[cpu];
+        return n < 0 ? 0 : n;
+    }
+
+    // No em que a thread roda agora. Thread sem afinidade pode
+    // migrar depois: fixe a CPU antes de perguntar.
+    [[nodiscard]]
+    inline int current_node() noexcept {
+        if (!numa_topology().multi_node()) return 0;
+        unsigned cpu = 0, node = 0;
+    #if defined(SYS_getcpu)
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return (int)node;
+    #endif
+        return node_of_cpu((int)cpu);
+    }
+
+    // ============================================================
+    // bind_to_node - politica MPOL_PREFERRED no intervalo
+    // O intervalo e reduzido as paginas inteiras dentro dele.
+    // move: migra paginas ja alocadas (MPOL_MF_MOVE).
+    // Um no so: nada a fazer, true.
+    // ============================================================
+    inline bool bind_to_node(void* p, size_t bytes, int node, bool move = true) noexcept {
+        if (!numa_topology().multi_node()) return true;
+        if (!p || node < 0 || node >= (int)NUMA_MAX_NODES) return false;
+
+        const uintptr_t lo = detail::round_up(reinterpret_cast<uintptr_t>(p), PAGE_4K);
+        const uintptr_t hi = (reinterpret_cast<uintptr_t>(p) + bytes) & ~(uintptr_t)(PAGE_4K - 1);
+        if (hi <= lo) return true;
+
+        unsigned long mask[NUMA_MAX_NODES / (8 * sizeof(unsigned long))] = {};
+        mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    #if defined(SYS_mbind)
+        return syscall(SYS_mbind, lo, hi - lo, MPOL_PREFERRED, mask,
+                       (unsigned long)NUMA_MAX_NODES + 1,
+                       move ? MPOL_MF_MOVE : 0) == 0;
+    #else
+        (void)mask; (void)move;
+        return false;
+    #endif
+    }
+
+    // ============================================================
+    // map_on_node - memoria anonima cujas paginas nascem no no
+    // Politica aplicada antes do primeiro toque; populate toca
+    // todas as paginas aqui. node < 0: map_anonymous comum.
+    // ============================================================
+    [[nodiscard]]
+    inline PageMapping map_on_node(size_t bytes, PageHint hint, int node,
+                                   bool populate = true) noexcept {
+        if (node < 0 || !numa_topology().multi_node())
+            return map_anonymous(bytes, hint, populate);
+
+        PageMapping m = map_anonymous(bytes, hint, false);
+        if (!m.ok()) return m;
+        (void)bind_to_node(m.ptr, m.bytes, node, false);
+        if (populate) {
+            detail::touch(m.ptr, m.bytes, true);
+            if (m.page == PageSize::THP && thp_backed_bytes(m.ptr) == 0)
+                m.page = PageSize::SMALL_4K;
+        }
+        return m;
+    }
+
+    // ============================================================
+    // NodeLocal<T> - T construido numa regiao mapeada no no
+    // Para objetos grandes de hot path (NetworkQueue, MpscQueue)
+    // que hoje vivem em estaticos tocados pela thread principal.
+    // ============================================================
+    template<typename T>
+    class NodeLocal {
+    private:
+        PageMapping m_map;
+        T*          m_obj;
+
+    public:
+        template<typename... Args>
+        explicit NodeLocal(int node, Args&&... args) noexcept
+            : m_map(map_on_node(sizeof(T), PageHint::SMALL, node)), m_obj(nullptr) {
+            if (m_map.ok()) m_obj = ::new (m_map.ptr) T(std::forward<Args>(args)...);
+        }
+
+        ~NodeLocal() {
+            if (m_obj) m_obj->~T();
+            unmap(m_map);
+        }
+
+        NodeLocal(const NodeLocal&)            = delete;
+        NodeLocal& operator=(const NodeLocal&) = delete;
+
+        // false: mmap falhou, get() == nullptr
+        [[nodiscard]]
+        bool ok() const noexcept { return m_obj != nullptr; }
+
+        [[nodiscard]]
+        T* get() const noexcept { return m_obj; }
+
+        T& operator*()  const noexcept { return *m_obj; }
+        T* operator->() const noexcept { return m_obj; }
+    };
+
+} // namespace petronilho::platform
@@ -24,6 +24,7 @@
     #include <intrin.h>
 #else
     #include <x86intrin.h>
+    #include <time.h>
 #endif
 
 namespace petronilho::platform {
@@ -1,9 +1,37 @@
-// Layer: L0 | Version: 2.2.0 | Author: Fabio Petronilho de Oliveira
+// Layer: L0 | Version: 2.4.0 | Author: Fabio Petronilho de Oliveira
 //
 // ================================================================
-// arena.hpp - Arena Unificada v2.2
+// arena.hpp - Arena Unificada v2.4
 // ================================================================
 //
+// MELHORIA v2.4: contadores opcionais (arena_stats.hpp)
+// Com PETRONILHO_ARENA_STATS=1: refills, resto abandonado de cada
+// chunk, histograma de tamanhos, high-water, falhas e bytes por
+// subsistema (allocate<T>(n, ArenaTag)), lidos por stats().
+// Sem a flag o codigo gerado e o mesmo da v2.3.
+// O ponteiro para os contadores da thread fica numa tabela TLS
+// propria (t_counters), fora do chunk: despejar o chunk nao perde
+// o slot. O resto de um chunk despejado conta como tail_waste da
+// arena dona, achada pelo id na lista de arenas vivas.
+//
+// MELHORIA v2.3: reset() por epoca, seguro com threads alocando
+// Antes reset() rebobinava m_offset e limpava so o chunk TLS da
+// thread que chamou; as outras seguiam escrevendo no chunk antigo,
+// sobreposto a memoria entregue de novo. Agora:
+//   - reset() zera m_offset e avanca m_epoch
+//   - cada chunk TLS guarda a epoca em que foi tirado
+//   - allocate() confere a epoca: chunk de epoca antiga e
+//     descartado e a thread pega um novo no proximo refill
+// Sem parada global: a thread so percebe o reset na proxima
+// alocacao. Custo no caminho rapido: uma leitura de m_epoch,
+// numa linha so lida (nao disputa com m_offset).
+// Semantica: reset() invalida toda alocacao linearizada antes
+// dele, inclusive as que terminam durante o reset.
+//
+// Chunks TLS agora sao por arena (ate TLS_SLOTS arenas por
+// thread, identificadas por id unico): antes t_chunk era um so
+// por thread e duas arenas usadas pela mesma thread se misturavam.
+//
 // MELHORIA v2.2 vs v2.1:
 // TLS_CHUNK adaptativo em vez de fixo.
 // Motivo: objeto maior que 64KB causava refill a cada alocacao,
@@ -23,6 +51,8 @@
 // v2.0: unificou arena_atomic + arena_thread_local
 // v2.1: alignof(T) em vez de alinhamento fixo 16
 // v2.2: TLS_CHUNK adaptativo para objetos grandes
+// v2.3: reset por epoca; chunk TLS por arena
+// v2.4: contadores por thread e tags de subsistema (opcionais)
 //
 // ALGORITMO: Bump Allocator Hierarquico
 // BASE TEORICA: Cormen Cap.17 Sec.17.1 - Aggregate Analysis
@@ -30,7 +60,10 @@
 
 #pragma once
 #include "handle.hpp"
+#include "arena_stats.hpp"
 #include "core/platform/memory_util.hpp"
+#include "core/platform/huge_pages.hpp"
+#include "core/platform/numa.hpp"
 #include <atomic>
 #include <cstdint>
 #include <cstddef>
@@ -43,13 +76,19 @@ namespace petronilho::sys {
         static constexpr size_t TLS_CHUNK_MIN  = 64  * 1024; // 64KB
         static constexpr size_t TLS_CHUNK_MAX  = 256 * 1024; // 256KB teto
         static constexpr size_t BASE_ALIGNMENT = 64;         // AVX512
+        static constexpr uint32_t TLS_SLOTS    = 4;          // arenas por thread
+        static constexpr uint32_t STATS_SLOTS  = 16;         // contadores por thread
 
         // Calcula tamanho ideal do chunk para um objeto
         // Se objeto cabe em 64KB usa 64KB
         // Se objeto e maior usa objeto * 2 ate o teto de 256KB
+        // Objeto acima do teto recebe chunk exato do seu tamanho:
+        // o teto nunca pode gerar chunk menor que o proprio objeto
         static constexpr size_t chunk_for(size_t obj_size) noexcept {
             if (obj_size <= TLS_CHUNK_MIN)
                 return TLS_CHUNK_MIN;
+            if (obj_size >= TLS_CHUNK_MAX)
+                return obj_size;
             const size_t ideal = obj_size * 2;
             return ideal < TLS_CHUNK_MAX ? ideal : TLS_CHUNK_MAX;
         }
@@ -57,21 +96,125 @@ namespace petronilho::sys {
 
     class ScalableArena {
     private:
-        uint8_t*                        m_base;
-        size_t                          m_capacity;
-        alignas(64) std::atomic<size_t> m_offset;
+        uint8_t*                          m_base;
+        size_t                            m_capacity;
+        platform::PageMapping             m_mapping;  // so se a arena e dona
+        uint64_t                          m_id;       // dono dos chunks TLS
+        alignas(64) std::atomic<size_t>   m_offset;
+        alignas(64) std::atomic<uint64_t> m_epoch;    // lido a cada allocate
+    #if PETRONILHO_ARENA_STATS
+        detail::ArenaStatsRegistry        m_stats;
+        ScalableArena*                    m_next_live = nullptr;  // lista do Registry
+    #endif
 
         struct ThreadChunk {
-            uint8_t* base = nullptr;
-            size_t   used = 0;
-            size_t   size = 0;
+            uint64_t arena = 0;    // m_id do dono; 0 = livre
+            uint64_t epoch = 0;
+            uint8_t* base  = nullptr;
+            size_t   used  = 0;
+            size_t   size  = 0;
+        #if PETRONILHO_ARENA_STATS
+            uint32_t stats = 0;    // dica: indice em t_counters
+        #endif
 
             bool has_space(size_t need) const noexcept {
                 return base && (used + need <= size);
             }
         };
 
-        static thread_local ThreadChunk t_chunk;
+        static thread_local ThreadChunk t_chunks[ArenaConfig::TLS_SLOTS];
+        static thread_local uint32_t    t_victim;
+
+    #if PETRONILHO_ARENA_STATS
+        // Contadores desta thread por arena, independentes dos chunks
+        struct ThreadCounters {
+            uint64_t                     arena = 0;   // m_id; 0 = livre
+            detail::ArenaThreadCounters* ptr   = nullptr;
+        };
+
+        // Arenas vivas: o despejo de um chunk acha a dona pelo id
+        struct Registry {
+            std::atomic_flag lock = ATOMIC_FLAG_INIT;
+            ScalableArena*   head = nullptr;
+        };
+
+        static thread_local ThreadCounters t_counters[ArenaConfig::STATS_SLOTS];
+        static thread_local uint32_t       t_counters_victim;
+
+        static Registry& registry() noexcept {
+            static Registry r;
+            return r;
+        }
+
+        static void lock(std::atomic_flag& f) noexcept {
+            while (f.test_and_set(std::memory_order_acquire)) _mm_pause();
+        }
+
+        static void unlock(std::atomic_flag& f) noexcept { f.clear(std::memory_order_release); }
+
+        void register_live() noexcept {
+            Registry& r = registry();
+            lock(r.lock);
+            m_next_live = r.head;
+            r.head = this;
+            unlock(r.lock);
+        }
+
+        // Resto de um chunk despejado: tail_waste da dona, se ela
+        // ainda existe e o chunk e da epoca atual. O lock do
+        // registro impede a dona de ser destruida no meio
+        static void waste_evicted(const ThreadChunk& c) noexcept {
+            Registry& r = registry();
+            lock(r.lock);
+            for (ScalableArena* a = r.head; a; a = a->m_next_live) {
+                if (a->m_id != c.arena) continue;
+                if (c.epoch == a->m_epoch.load(std::memory_order_relaxed)) {
+                    uint32_t hint = 0;
+                    detail::ArenaThreadCounters& st = a->counters(hint);
+                    st.bump(st.tail_waste, c.size - c.used);
+                }
+                break;
+            }
+            unlock(r.lock);
+        }
+    #endif
+
+        static uint64_t next_id() noexcept {
+            static std::atomic<uint64_t> s_ids{1};
+            return s_ids.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Chunk desta arena nesta thread; sem slot, substitui um
+        // em rodizio (o resto do chunk substituido e perdido)
+        PETRONILHO_FORCE_INLINE ThreadChunk& local_chunk() const noexcept {
+            for (uint32_t i = 0; i < ArenaConfig::TLS_SLOTS; ++i)
+                if (t_chunks[i].arena == m_id) return t_chunks[i];
+            ThreadChunk& c = t_chunks[t_victim++ % ArenaConfig::TLS_SLOTS];
+        #if PETRONILHO_ARENA_STATS
+            if (c.base) waste_evicted(c);
+        #endif
+            c = ThreadChunk{};
+            c.arena = m_id;
+            return c;
+        }
+
+    #if PETRONILHO_ARENA_STATS
+        // Contadores desta thread nesta arena. hint: ultimo indice
+        // em t_counters; sem entrada, toma uma em rodizio (claim()
+        // devolve o mesmo slot a mesma thread)
+        PETRONILHO_FORCE_INLINE detail::ArenaThreadCounters& counters(uint32_t& hint) noexcept {
+            if (t_counters[hint].arena == m_id) [[likely]] return *t_counters[hint].ptr;
+            for (uint32_t i = 0; i < ArenaConfig::STATS_SLOTS; ++i)
+                if (t_counters[i].arena == m_id) { hint = i; return *t_counters[i].ptr; }
+            hint = t_counters_victim++ % ArenaConfig::STATS_SLOTS;
+            t_counters[hint] = ThreadCounters{ m_id, &m_stats.claim() };
+            return *t_counters[hint].ptr;
+        }
+
+        PETRONILHO_FORCE_INLINE detail::ArenaThreadCounters& counters(ThreadChunk& c) noexcept {
+            return counters(c.stats);
+        }
+    #endif
 
         // ============================================================
         // refill_chunk - pede novo chunk do global
@@ -79,63 +222,144 @@ namespace petronilho::sys {
         // MELHORIA v2.2: chunk_size adaptativo via ArenaConfig::chunk_for
         // Evita refill por alocacao em objetos grandes
         //
+        // v2.3: a epoca e lida antes e depois do fetch_add. reset()
+        // zera m_offset ANTES de avancar m_epoch, entao epocas iguais
+        // garantem que o offset pertence a essa epoca; diferentes,
+        // o pedaco e abandonado e o refill refeito.
+        //
         // Cormen Cap.17: custo do refill diluido entre
         // todas as alocacoes locais do chunk.
         // ============================================================
-        bool refill_chunk(size_t obj_size) noexcept {
+        bool refill_chunk(ThreadChunk& c, size_t obj_size) noexcept {
             const size_t chunk_size = ArenaConfig::chunk_for(obj_size);
+        #if PETRONILHO_ARENA_STATS
+            // Resto do chunk da epoca atual que sera abandonado
+            detail::ArenaThreadCounters& st = counters(c);
+            if (c.base && c.epoch == m_epoch.load(std::memory_order_relaxed))
+                st.bump(st.tail_waste, c.size - c.used);
+        #endif
 
-            const size_t off = m_offset.fetch_add(
-                chunk_size, std::memory_order_relaxed);
+            for (;;) {
+                const uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+                const size_t off = m_offset.fetch_add(
+                    chunk_size, std::memory_order_seq_cst);
+                if (m_epoch.load(std::memory_order_seq_cst) != epoch) continue;
 
-            if (off + chunk_size > m_capacity) return false;
+                if (off + chunk_size > m_capacity) {
+                #if PETRONILHO_ARENA_STATS
+                    st.bump(st.failed, 1);
+                #endif
+                    return false;
+                }
+            #if PETRONILHO_ARENA_STATS
+                st.bump(st.refills, 1);
+                m_stats.on_offset(off + chunk_size);
+            #endif
 
-            t_chunk.base = m_base + off;
-            t_chunk.used = 0;
-            t_chunk.size = chunk_size;
-            return true;
+                c.epoch = epoch;
+                c.base  = m_base + off;
+                c.used  = 0;
+                c.size  = chunk_size;
+                return true;
+            }
         }
 
     public:
         ScalableArena(void* buffer, size_t size) noexcept
             : m_base(static_cast<uint8_t*>(buffer))
             , m_capacity(size)
+            , m_id(next_id())
             , m_offset(0)
-        {}
+            , m_epoch(0)
+        {
+        #if PETRONILHO_ARENA_STATS
+            register_live();
+        #endif
+        }
+
+        // Arena dona da memoria: mapeamento anonimo pre-carregado,
+        // em paginas grandes se hint = HUGE (huge_pages.hpp). Falha
+        // de mmap: capacity() == 0 e toda alocacao devolve null.
+        // node >= 0: paginas no no NUMA (numa.hpp); -1 = first-touch
+        // da thread que constroi.
+        ScalableArena(size_t size, platform::PageHint hint, int node = -1) noexcept
+            : m_mapping(platform::map_on_node(size, hint, node))
+            , m_id(next_id())
+            , m_offset(0)
+            , m_epoch(0)
+        {
+            m_base     = static_cast<uint8_t*>(m_mapping.ptr);
+            m_capacity = m_mapping.ok() ? size : 0;
+        #if PETRONILHO_ARENA_STATS
+            register_live();
+        #endif
+        }
+
+        ~ScalableArena() {
+        #if PETRONILHO_ARENA_STATS
+            Registry& r = registry();
+            lock(r.lock);
+            for (ScalableArena** p = &r.head; *p; p = &(*p)->m_next_live)
+                if (*p == this) { *p = m_next_live; break; }
+            unlock(r.lock);
+        #endif
+            platform::unmap(m_mapping);
+        }
 
         ScalableArena(const ScalableArena&)            = delete;
         ScalableArena& operator=(const ScalableArena&) = delete;
 
         static void initialize_thread() noexcept {
-            t_chunk = {};
+            for (uint32_t i = 0; i < ArenaConfig::TLS_SLOTS; ++i) t_chunks[i] = {};
+            t_victim = 0;
         }
 
+        // tag: subsistema dono (so contado com PETRONILHO_ARENA_STATS)
         template<typename T>
         [[nodiscard]]
-        Handle<T> allocate(size_t count = 1) noexcept {
+        Handle<T> allocate(size_t count = 1, ArenaTag tag = ArenaTag::NONE) noexcept {
             const size_t raw       = sizeof(T) * count;
             const size_t alignment = alignof(T);
             const size_t aligned   =
                 (raw + (alignment - 1)) & ~(alignment - 1);
 
-            if (t_chunk.has_space(aligned)) {
-                uint8_t* ptr  = t_chunk.base + t_chunk.used;
-                t_chunk.used += aligned;
+            ThreadChunk& c = local_chunk();
+            if (c.epoch == m_epoch.load(std::memory_order_acquire)
+                && c.has_space(aligned)) {
+            #if PETRONILHO_ARENA_STATS
+                counters(c).on_alloc(aligned, tag);
+            #else
+                (void)tag;
+            #endif
+                uint8_t* ptr = c.base + c.used;
+                c.used += aligned;
                 return Handle<T>{
                     static_cast<uint32_t>(ptr - m_base), m_base };
             }
 
-            if (!refill_chunk(aligned)) return Handle<T>::null();
+            if (!refill_chunk(c, aligned)) return Handle<T>::null();
 
-            uint8_t* ptr  = t_chunk.base;
-            t_chunk.used  = aligned;
+        #if PETRONILHO_ARENA_STATS
+            counters(c).on_alloc(aligned, tag);
+        #endif
+            uint8_t* ptr = c.base;
+            c.used = aligned;
             return Handle<T>{
                 static_cast<uint32_t>(ptr - m_base), m_base };
         }
 
+        // ============================================================
+        // reset - recicla a arena sem parar as outras threads
+        // Ordem importa (ver refill_chunk): offset primeiro, epoca
+        // depois. Cada thread descarta o proprio chunk na proxima
+        // alocacao.
+        // ============================================================
         void reset() noexcept {
-            m_offset.store(0, std::memory_order_relaxed);
-            t_chunk = {};
+            m_offset.store(0, std::memory_order_seq_cst);
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        #if PETRONILHO_ARENA_STATS
+            m_stats.on_reset();
+        #endif
         }
 
         [[nodiscard]]
@@ -145,9 +369,56 @@ namespace petronilho::sys {
 
         [[nodiscard]]
         size_t capacity() const noexcept { return m_capacity; }
+
+        // Resets ate agora
+        [[nodiscard]]
+        uint64_t epoch() const noexcept {
+            return m_epoch.load(std::memory_order_acquire);
+        }
+
+        // Pagina do mapeamento proprio (4KB se o buffer veio de fora)
+        [[nodiscard]]
+        platform::PageSize page_size() const noexcept { return m_mapping.page; }
+
+        // Soma de todas as threads. enabled == false: compilado sem
+        // PETRONILHO_ARENA_STATS, tudo zero
+        [[nodiscard]]
+        ArenaStats stats() const noexcept {
+        #if PETRONILHO_ARENA_STATS
+            return m_stats.total();
+        #else
+            return ArenaStats{};
+        #endif
+        }
+
+        // Threads que ja alocaram (ordem da primeira alocacao)
+        [[nodiscard]]
+        uint32_t stats_threads() const noexcept {
+        #if PETRONILHO_ARENA_STATS
+            return m_stats.threads();
+        #else
+            return 0;
+        #endif
+        }
+
+        [[nodiscard]]
+        ArenaStats thread_stats(uint32_t i) const noexcept {
+        #if PETRONILHO_ARENA_STATS
+            return m_stats.thread(i);
+        #else
+            (void)i;
+            return ArenaStats{};
+        #endif
+        }
     };
 
     inline thread_local ScalableArena::ThreadChunk
-        ScalableArena::t_chunk{};
+        ScalableArena::t_chunks[ArenaConfig::TLS_SLOTS]{};
+    inline thread_local uint32_t ScalableArena::t_victim = 0;
+#if PETRONILHO_ARENA_STATS
+    inline thread_local ScalableArena::ThreadCounters
+        ScalableArena::t_counters[ArenaConfig::STATS_SLOTS]{};
+    inline thread_local uint32_t ScalableArena::t_counters_victim = 0;
+#endif
 
 } // namespace petronilho::sys
\ No newline at end of file
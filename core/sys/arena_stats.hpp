@@ -0,0 +1,243 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// arena_stats.hpp - Contadores de Arena (opcionais em compilacao)
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// ScalableArena nao dizia nada sobre o proprio comportamento:
+// refill_chunk abandona o resto de cada chunk em silencio e used()
+// so mostra o offset global. Com PETRONILHO_ARENA_STATS=1 cada
+// arena conta, por thread:
+//
+//   allocations / bytes : alocacoes servidas e bytes pedidos
+//   failed              : alocacoes que devolveram null
+//   refills             : chunks TLS tomados do offset global
+//   tail_waste          : bytes abandonados no fim de chunks
+//   size_hist           : alocacoes por potencia de 2 do tamanho
+//   tag_*               : alocacoes e bytes por subsistema (ArenaTag)
+//
+// e, por arena, o high-water mark do offset e o numero de resets.
+// stats() soma as threads num ArenaStats; thread_stats(i) devolve
+// uma so. Leitura a qualquer momento, de qualquer thread.
+//
+// Cada thread tem um slot por arena: claim() o procura pela marca
+// da thread antes de tomar um novo, entao pedir de novo (cache da
+// thread despejado) nao gasta slot nem divide a thread em duas.
+//
+// CUSTO: cada thread escreve so nos seus contadores (linha
+// propria, load + store relaxed, sem RMW). O high-water e
+// atualizado so no refill. Com PETRONILHO_ARENA_STATS=0 (padrao)
+// nada disso existe: nenhum membro, nenhuma instrucao.
+//
+// Threads alem de ARENA_STATS_THREADS dividem um slot extra com
+// fetch_add.
+//
+// ALGORITMO: Contadores Particionados (sharded counters)
+// BASE TEORICA: Cormen Cap.27 - Multithreaded Algorithms
+// Um contador por thread elimina a disputa de escrita; a soma e
+// feita na leitura, que e rara (reducao do Cormen 27.1).
+//
+// Complexidade: registro O(1); claim() O(threads), uma vez por
+//               thread e arena; stats() O(threads x contadores)
+// ================================================================
+
+#pragma once
+#include "core/platform/platform_detect.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+#ifndef PETRONILHO_ARENA_STATS
+    #define PETRONILHO_ARENA_STATS 0
+#endif
+
+namespace petronilho::sys {
+
+    // Subsistema dono da alocacao
+    enum class ArenaTag : uint8_t { NONE, HEAP, HASH, NET, POOL, COUNT };
+
+    static constexpr uint32_t ARENA_TAGS          = static_cast<uint32_t>(ArenaTag::COUNT);
+    static constexpr uint32_t ARENA_SIZE_BUCKETS  = 32;   // [2^(b-1), 2^b); ultimo: >= 1GB
+    static constexpr uint32_t ARENA_STATS_THREADS = 64;
+
+    [[nodiscard]]
+    inline const char* arena_tag_name(ArenaTag t) noexcept {
+        switch (t) {
+            case ArenaTag::HEAP:    return "heap";
+            case ArenaTag::HASH:    return "hash";
+            case ArenaTag::NET:     return "net";
+            case ArenaTag::POOL:    return "pool";
+            default:                return "none";
+        }
+    }
+
+    // Balde do histograma: largura em bits do tamanho
+    [[nodiscard]]
+    constexpr uint32_t arena_size_bucket(size_t bytes) noexcept {
+        const uint32_t b = static_cast<uint32_t>(std::bit_width(bytes));
+        return b < ARENA_SIZE_BUCKETS ? b : ARENA_SIZE_BUCKETS - 1;
+    }
+
+    // Retrato (valores simples, copiavel)
+    struct ArenaStats {
+        bool     enabled     = false;   // compilado com PETRONILHO_ARENA_STATS
+        uint32_t threads     = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes       = 0;
+        uint64_t failed      = 0;
+        uint64_t refills     = 0;
+        uint64_t tail_waste  = 0;
+        uint64_t high_water  = 0;       // maior offset global ja tomado (add: o maior)
+        uint64_t resets      = 0;
+        uint64_t size_hist[ARENA_SIZE_BUCKETS] = {};
+        uint64_t tag_allocs[ARENA_TAGS]        = {};
+        uint64_t tag_bytes[ARENA_TAGS]         = {};
+
+        // Soma outro retrato (threads, arenas de varios nos). O
+        // high-water e por arena: fica o maior, nao a soma
+        void add(const ArenaStats& o) noexcept {
+            enabled      = enabled || o.enabled;
+            threads     += o.threads;
+            allocations += o.allocations;
+            bytes       += o.bytes;
+            failed      += o.failed;
+            refills     += o.refills;
+            tail_waste  += o.tail_waste;
+            high_water   = high_water > o.high_water ? high_water : o.high_water;
+            resets      += o.resets;
+            for (uint32_t i = 0; i < ARENA_SIZE_BUCKETS; ++i) size_hist[i] += o.size_hist[i];
+            for (uint32_t i = 0; i < ARENA_TAGS; ++i) {
+                tag_allocs[i] += o.tag_allocs[i];
+                tag_bytes[i]  += o.tag_bytes[i];
+            }
+        }
+    };
+
+    namespace detail {
+
+        // Marca unica da thread que chama (0 = nenhuma)
+        [[nodiscard]]
+        inline uint64_t arena_thread_mark() noexcept {
+            static std::atomic<uint64_t> s_marks{1};
+            static thread_local uint64_t t_mark = s_marks.fetch_add(1, std::memory_order_relaxed);
+            return t_mark;
+        }
+
+        // Contadores de uma thread. shared: slot de transbordo,
+        // escrito por varias threads com fetch_add
+        struct alignas(64) ArenaThreadCounters {
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> failed{0};
+            std::atomic<uint64_t> refills{0};
+            std::atomic<uint64_t> tail_waste{0};
+            std::atomic<uint64_t> size_hist[ARENA_SIZE_BUCKETS] = {};
+            std::atomic<uint64_t> tag_allocs[ARENA_TAGS] = {};
+            std::atomic<uint64_t> tag_bytes[ARENA_TAGS]  = {};
+            std::atomic<uint64_t> owner{0};   // arena_thread_mark do dono
+            bool                  shared = false;
+
+            PETRONILHO_FORCE_INLINE void bump(std::atomic<uint64_t>& c, uint64_t v) noexcept {
+                if (shared) c.fetch_add(v, std::memory_order_relaxed);
+                else        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+            }
+
+            PETRONILHO_FORCE_INLINE void on_alloc(size_t n, ArenaTag tag) noexcept {
+                const uint32_t t = static_cast<uint32_t>(tag);
+                bump(allocations, 1);
+                bump(bytes, n);
+                bump(size_hist[arena_size_bucket(n)], 1);
+                bump(tag_allocs[t], 1);
+                bump(tag_bytes[t], n);
+            }
+
+            void read_into(ArenaStats& s) const noexcept {
+                s.allocations += allocations.load(std::memory_order_relaxed);
+                s.bytes       += bytes.load(std::memory_order_relaxed);
+                s.failed      += failed.load(std::memory_order_relaxed);
+                s.refills     += refills.load(std::memory_order_relaxed);
+                s.tail_waste  += tail_waste.load(std::memory_order_relaxed);
+                for (uint32_t i = 0; i < ARENA_SIZE_BUCKETS; ++i)
+                    s.size_hist[i] += size_hist[i].load(std::memory_order_relaxed);
+                for (uint32_t i = 0; i < ARENA_TAGS; ++i) {
+                    s.tag_allocs[i] += tag_allocs[i].load(std::memory_order_relaxed);
+                    s.tag_bytes[i]  += tag_bytes[i].load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        class ArenaStatsRegistry {
+        private:
+            ArenaThreadCounters               m_threads[ARENA_STATS_THREADS + 1];
+            std::atomic<uint32_t>             m_claimed{0};
+            alignas(64) std::atomic<uint64_t> m_high_water{0};
+            std::atomic<uint64_t>             m_resets{0};
+
+        public:
+            ArenaStatsRegistry() noexcept {
+                m_threads[ARENA_STATS_THREADS].shared = true;
+            }
+
+            // Slot da thread que chama: o que ela ja tem, ou um novo.
+            // So a propria thread grava a sua marca, entao duas
+            // chamadas nunca tomam dois slots
+            [[nodiscard]]
+            ArenaThreadCounters& claim() noexcept {
+                const uint64_t me = arena_thread_mark();
+                const uint32_t n  = m_claimed.load(std::memory_order_acquire);
+                for (uint32_t i = 0; i < n && i < ARENA_STATS_THREADS; ++i)
+                    if (m_threads[i].owner.load(std::memory_order_relaxed) == me)
+                        return m_threads[i];
+                const uint32_t i = m_claimed.fetch_add(1, std::memory_order_acq_rel);
+                if (i >= ARENA_STATS_THREADS) {
+                    // Transbordo nao avanca mais a contagem
+                    m_claimed.store(ARENA_STATS_THREADS, std::memory_order_relaxed);
+                    return m_threads[ARENA_STATS_THREADS];
+                }
+                m_threads[i].owner.store(me, std::memory_order_relaxed);
+                return m_threads[i];
+            }
+
+            void on_offset(uint64_t end) noexcept {
+                uint64_t hw = m_high_water.load(std::memory_order_relaxed);
+                while (end > hw && !m_high_water.compare_exchange_weak(
+                           hw, end, std::memory_order_relaxed)) {}
+            }
+
+            void on_reset() noexcept { m_resets.fetch_add(1, std::memory_order_relaxed); }
+
+            [[nodiscard]]
+            uint32_t threads() const noexcept {
+                const uint32_t n = m_claimed.load(std::memory_order_relaxed);
+                return n < ARENA_STATS_THREADS ? n : ARENA_STATS_THREADS + 1;
+            }
+
+            [[nodiscard]]
+            ArenaStats total() const noexcept {
+                ArenaStats s;
+                s.enabled    = true;
+                s.threads    = threads();
+                s.high_water = m_high_water.load(std::memory_order_relaxed);
+                s.resets     = m_resets.load(std::memory_order_relaxed);
+                for (uint32_t i = 0; i < s.threads; ++i) m_threads[i].read_into(s);
+                return s;
+            }
+
+            // Thread i (ordem de primeira alocacao); i == threads()-1
+            // pode ser o slot de transbordo
+            [[nodiscard]]
+            ArenaStats thread(uint32_t i) const noexcept {
+                ArenaStats s;
+                s.enabled = true;
+                if (i >= threads()) return s;
+                s.threads = 1;
+                m_threads[i].read_into(s);
+                return s;
+            }
+        };
+
+    } // namespace detail
+
+} // namespace petronilho::sys
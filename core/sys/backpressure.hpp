@@ -0,0 +1,287 @@
+// Layer: L1 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// backpressure.hpp - Politicas de Transbordo do Sink
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Decide o que acontece quando o destino (RingBuffer, NetworkQueue)
+// esta cheio no momento do publish. Cada politica e um tipo, como
+// as estrategias de espera; o sink recebe a politica como
+// parametro de template e nao paga por nenhuma outra:
+//
+//   DropNewest       : descarta o datagrama que chegou (padrao,
+//                      comportamento anterior).
+//   DropOldest       : descarta o mais antigo do destino (CAS no
+//                      indice de leitura) e grava o novo.
+//   BlockWithTimeout : espera o consumidor liberar espaco ate
+//                      timeout_ns; depois descarta. Limita o tempo
+//                      que o caminho de recepcao fica parado.
+//   Spill            : grava o excedente num arquivo de transbordo
+//                      (PersistentArena) e devolve ao destino, em
+//                      ordem, quando houver espaco (pump).
+//
+// CONTRATO COM O SINK (Target):
+//   bool try_push(const Datagram&)   - tentativa normal
+//   bool overwrite(const Datagram&)  - grava descartando o antigo;
+//                                      false = nao gravou
+//   bool can_copy()                  - o sink consegue devolver o
+//                                      original ao backend agora
+//   void copied(const Datagram&)     - politica copiou d; o
+//                                      original pode voltar ao
+//                                      backend
+//   bool restore(const Datagram&)    - devolve um registro do
+//                                      transbordo (d.data aponta
+//                                      para o arquivo)
+//
+// COPIES = true: admit copia o payload antes de retornar ou o
+// descarta (Spill). O sink pode entao oferecer um datagrama cujo
+// buffer o backend reusa em seguida, recusando-o em try_push.
+//
+// ORDEM NO SPILL: enquanto houver registros no arquivo, todo
+// datagrama novo tambem vai para o arquivo. O destino recebe os
+// datagramas na ordem de chegada.
+//
+// ALGORITMO: Fila de Transbordo FIFO em Memoria Mapeada
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas
+//               Cormen Cap.17 - Analise Amortizada
+// O arquivo e uma fila: spill enfileira no fim (bump), pump
+// desenfileira do inicio. Esvaziada, a arena volta ao inicio:
+// cada byte gravado e lido uma vez, custo amortizado O(1).
+//
+// Complexidade: admit O(1) (+ O(len) no spill), pump O(k)
+// Thread-safety: thread do produtor (motor) apenas
+// ================================================================
+
+#pragma once
+#include "ingest_engine.hpp"
+#include "persistent_arena.hpp"
+#include "core/platform/platform_detect.hpp"
+#include "core/platform/timer_util.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace petronilho::net {
+
+    // ============================================================
+    // DropNewest - o datagrama que chegou e descartado
+    // ============================================================
+    struct DropNewestCounters {
+        uint64_t dropped = 0;
+    };
+
+    class DropNewest {
+    private:
+        DropNewestCounters m_counters;
+
+    public:
+        static constexpr const char* NAME       = "drop-newest";
+        static constexpr bool        OVERWRITES = false;
+        static constexpr bool        COPIES     = false;
+
+        template<typename Target>
+        PETRONILHO_FORCE_INLINE bool admit(const Datagram& d, Target& t) noexcept {
+            if (t.try_push(d)) return true;
+            ++m_counters.dropped;
+            return false;
+        }
+
+        template<typename Target>
+        PETRONILHO_FORCE_INLINE uint32_t pump(Target&) noexcept { return 0; }
+
+        [[nodiscard]]
+        const DropNewestCounters& counters() const noexcept { return m_counters; }
+    };
+
+    // ============================================================
+    // DropOldest - o mais antigo do destino da lugar ao novo
+    // ============================================================
+    struct DropOldestCounters {
+        uint64_t overwritten = 0;  // gravados no lugar do mais antigo
+        uint64_t dropped     = 0;  // sink recusou sobrescrever
+    };
+
+    class DropOldest {
+    private:
+        DropOldestCounters m_counters;
+
+    public:
+        static constexpr const char* NAME       = "drop-oldest";
+        static constexpr bool        OVERWRITES = true;
+        static constexpr bool        COPIES     = false;
+
+        template<typename Target>
+        PETRONILHO_FORCE_INLINE bool admit(const Datagram& d, Target& t) noexcept {
+            if (t.try_push(d)) return true;
+            if (t.overwrite(d)) { ++m_counters.overwritten; return true; }
+            ++m_counters.dropped;
+            return false;
+        }
+
+        template<typename Target>
+        PETRONILHO_FORCE_INLINE uint32_t pump(Target&) noexcept { return 0; }
+
+        [[nodiscard]]
+        const DropOldestCounters& counters() const noexcept { return m_counters; }
+    };
+
+    // ============================================================
+    // BlockWithTimeout - espera o consumidor ate timeout_ns
+    // ============================================================
+    struct BlockCounters {
+        uint64_t waits       = 0;  // publishes que encontraram cheio
+        uint64_t timeouts    = 0;  // esperas sem espaco: descartados
+        uint64_t blocked_ns  = 0;  // tempo total parado
+        uint64_t max_wait_ns = 0;
+    };
+
+    class BlockWithTimeout {
+    private:
+        BlockCounters m_counters;
+        uint64_t      m_timeout_ns;
+
+    public:
+        static constexpr const char* NAME       = "block";
+        static constexpr bool        OVERWRITES = false;
+        static constexpr bool        COPIES     = false;
+
+        explicit BlockWithTimeout(uint64_t timeout_ns = 100000) noexcept
+            : m_timeout_ns(timeout_ns) {}
+
+        template<typename Target>
+        bool admit(const Datagram& d, Target& t) noexcept {
+            if (t.try_push(d)) return true;
+
+            ++m_counters.waits;
+            const uint64_t start = platform::now_ns();
+            uint64_t now = start;
+            bool ok = false;
+            while (now - start < m_timeout_ns) {
+                _mm_pause();
+                if (t.try_push(d)) { ok = true; break; }
+                now = platform::now_ns();
+            }
+            if (ok) now = platform::now_ns();
+            else    ++m_counters.timeouts;
+
+            const uint64_t waited = now - start;
+            m_counters.blocked_ns += waited;
+            if (waited > m_counters.max_wait_ns) m_counters.max_wait_ns = waited;
+            return ok;
+        }
+
+        template<typename Target>
+        PETRONILHO_FORCE_INLINE uint32_t pump(Target&) noexcept { return 0; }
+
+        [[nodiscard]]
+        const BlockCounters& counters() const noexcept { return m_counters; }
+
+        [[nodiscard]]
+        uint64_t timeout_ns() const noexcept { return m_timeout_ns; }
+    };
+
+    // ============================================================
+    // Spill - transbordo para arquivo, drenado por pump()
+    // ============================================================
+    struct SpillRecord {
+        uint64_t rx_ns;
+        uint64_t seq;
+        uint32_t len;
+        uint32_t lat_ns;
+        uint32_t magic;    // SPILL_MAGIC: registro valido
+        uint16_t segment;
+        uint16_t _pad;
+    };
+
+    static_assert(sizeof(SpillRecord) == 32, "SpillRecord deve ter 32 bytes");
+    static constexpr uint32_t SPILL_MAGIC = 0x5350494C;  // "SPIL"
+
+    struct SpillCounters {
+        uint64_t spilled      = 0;  // gravados no arquivo
+        uint64_t drained      = 0;  // devolvidos ao destino
+        uint64_t spill_full   = 0;  // sem espaco para copiar: descartados
+        uint64_t pending_peak = 0;  // maior fila no arquivo
+    };
+
+    class Spill {
+    private:
+        PersistentArena* m_area;
+        uint8_t*         m_read;     // proximo registro a drenar
+        uint64_t         m_pending;  // registros no arquivo
+        SpillCounters    m_counters;
+
+        // Registros sao alocados em sequencia, alinhados a 64B
+        [[nodiscard]]
+        static size_t record_bytes(uint32_t len) noexcept {
+            return (sizeof(SpillRecord) + len + 63) & ~size_t(63);
+        }
+
+    public:
+        static constexpr const char* NAME       = "spill";
+        static constexpr bool        OVERWRITES = false;
+        static constexpr bool        COPIES     = true;
+
+        explicit Spill(PersistentArena& area) noexcept
+            : m_area(&area), m_read(nullptr), m_pending(0) {}
+
+        template<typename Target>
+        bool admit(const Datagram& d, Target& t) noexcept {
+            if (m_pending == 0 && t.try_push(d)) return true;
+            if (!t.can_copy()) { ++m_counters.spill_full; return false; }
+
+            void* p = m_area->allocate(sizeof(SpillRecord) + d.len);
+            if (!p) { ++m_counters.spill_full; return false; }
+
+            SpillRecord* r = static_cast<SpillRecord*>(p);
+            r->rx_ns   = d.rx_ns;
+            r->seq     = d.seq;
+            r->len     = d.len;
+            r->lat_ns  = d.lat_ns;
+            r->segment = d.segment;
+            r->_pad    = 0;
+            std::memcpy(r + 1, d.data, d.len);
+            r->magic   = SPILL_MAGIC;
+
+            if (m_pending == 0) m_read = static_cast<uint8_t*>(p);
+            ++m_pending;
+            ++m_counters.spilled;
+            if (m_pending > m_counters.pending_peak) m_counters.pending_peak = m_pending;
+            t.copied(d);
+            return true;
+        }
+
+        // Devolve o que couber, em ordem. Arquivo vazio: reinicia.
+        template<typename Target>
+        uint32_t pump(Target& t) noexcept {
+            if (m_pending == 0) return 0;
+            uint32_t n = 0;
+            while (m_pending) {
+                const SpillRecord* r = reinterpret_cast<const SpillRecord*>(m_read);
+                Datagram d{};
+                d.data    = reinterpret_cast<const uint8_t*>(r + 1);
+                d.rx_ns   = r->rx_ns;
+                d.seq     = r->seq;
+                d.len     = r->len;
+                d.lat_ns  = r->lat_ns;
+                d.segment = r->segment;
+                if (!t.restore(d)) break;
+                m_read += record_bytes(r->len);
+                --m_pending;
+                ++m_counters.drained;
+                ++n;
+            }
+            if (m_pending == 0) {
+                m_area->reset();
+                m_read = nullptr;
+            }
+            return n;
+        }
+
+        [[nodiscard]]
+        uint64_t pending() const noexcept { return m_pending; }
+
+        [[nodiscard]]
+        const SpillCounters& counters() const noexcept { return m_counters; }
+    };
+
+} // namespace petronilho::net
@@ -0,0 +1,182 @@
+// Layer: L0 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// batch_receiver.hpp - Recepcao UDP em Lote via recvmmsg
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Troca N chamadas recv() por uma unica recvmmsg() que traz ate
+// N datagramas. Cada iovec aponta direto para o destino final
+// (slot da ScalableArena, PersistentArena ou do log mmap), entao
+// o kernel copia o payload uma unica vez, sem buffer de pilha.
+//
+// CONTROLE (v1.1): enable_control()
+// Reserva um buffer de cmsg por datagrama para carimbos RX do
+// kernel (rx_timestamp.hpp). header(i) expoe o msghdr preenchido.
+//
+// METRICA: packets_per_syscall()
+// Pacotes entregues / chamadas recvmmsg produtivas. Com N = 1 o
+// valor e 1.0 (equivale ao recv antigo). Subir N reduz o custo
+// de syscall por pacote, mas aumenta o tempo que o primeiro
+// pacote do lote espera: ajuste N contra o P99.
+//
+// ALGORITMO: Processamento em Lote (Batching)
+// BASE TEORICA: Cormen Cap.17 - Analise Amortizada
+// Cormen Sec.17.1: o custo fixo da syscall (troca de modo,
+// lookup do socket) e dividido entre os k pacotes do lote.
+// Custo amortizado por pacote: O(1 + C_syscall / k)
+//
+// Complexidade: receive O(k), consume O(N - k)
+// ================================================================
+
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace petronilho::net {
+
+    template<uint32_t MaxBatch>
+    class BatchReceiver {
+    public:
+        // Cabe carimbo RX (scm_timestamping) com folga
+        static constexpr size_t CONTROL_SPACE = 128;
+
+    private:
+        static_assert(MaxBatch >= 1, "MaxBatch minimo e 1");
+        static_assert(MaxBatch <= 1024,
+            "recvmmsg aceita no maximo UIO_MAXIOV mensagens");
+
+        mmsghdr  m_msgs[MaxBatch];
+        iovec    m_iov[MaxBatch];
+        alignas(8) uint8_t m_control[MaxBatch][CONTROL_SPACE];
+        uint32_t m_batch;
+        bool     m_control_on;
+
+        uint64_t m_syscalls;     // recvmmsg que retornaram >= 1
+        uint64_t m_empty_polls;  // recvmmsg que retornaram EAGAIN
+        uint64_t m_packets;
+
+    public:
+        explicit BatchReceiver(uint32_t batch = MaxBatch) noexcept
+            : m_batch(batch == 0 ? 1 : (batch > MaxBatch ? MaxBatch : batch))
+            , m_control_on(false)
+            , m_syscalls(0), m_empty_polls(0), m_packets(0)
+        {
+            std::memset(m_msgs, 0, sizeof(m_msgs));
+            std::memset(m_iov,  0, sizeof(m_iov));
+            for (uint32_t i = 0; i < MaxBatch; ++i) {
+                m_msgs[i].msg_hdr.msg_iov    = &m_iov[i];
+                m_msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+        }
+
+        BatchReceiver(const BatchReceiver&)            = delete;
+        BatchReceiver& operator=(const BatchReceiver&) = delete;
+
+        // Liga um buffer de cmsg por datagrama (carimbo RX etc.)
+        void enable_control() noexcept {
+            for (uint32_t i = 0; i < MaxBatch; ++i) {
+                m_msgs[i].msg_hdr.msg_control    = m_control[i];
+                m_msgs[i].msg_hdr.msg_controllen = CONTROL_SPACE;
+            }
+            m_control_on = true;
+        }
+
+        // Aponta o datagrama i do lote para o destino final
+        void set_buffer(uint32_t i, void* dst, size_t cap) noexcept {
+            m_iov[i].iov_base = dst;
+            m_iov[i].iov_len  = cap;
+        }
+
+        // ============================================================
+        // receive - Uma chamada recvmmsg para ate batch() datagramas
+        //
+        // Retorna k >= 1 pacotes recebidos, 0 se nao havia dados
+        // (EAGAIN/EWOULDBLOCK ou EINTR) e -1 em erro real (errno).
+        // Em socket bloqueante use flags = MSG_WAITFORONE para
+        // retornar assim que o primeiro datagrama chegar.
+        // ============================================================
+        [[nodiscard]]
+        int receive(int fd, int flags = 0) noexcept {
+            // O kernel reescreve msg_controllen com o tamanho usado
+            if (m_control_on)
+                for (uint32_t i = 0; i < m_batch; ++i)
+                    m_msgs[i].msg_hdr.msg_controllen = CONTROL_SPACE;
+
+            const int k = recvmmsg(fd, m_msgs, m_batch, flags, nullptr);
+            if (k > 0) {
+                ++m_syscalls;
+                m_packets += static_cast<uint64_t>(k);
+                return k;
+            }
+            if (k < 0 && errno != EAGAIN && errno != EWOULDBLOCK
+                      && errno != EINTR)
+                return -1;
+            ++m_empty_polls;
+            return 0;
+        }
+
+        // ============================================================
+        // consume - Descarta os k primeiros slots ja preenchidos
+        //
+        // Os slots que o kernel nao usou sobem para o inicio do
+        // lote, preservando a ordem de enderecos no destino.
+        // Retorna o primeiro indice que precisa de set_buffer():
+        // os slots [retorno, batch()) recebem buffers novos.
+        // ============================================================
+        [[nodiscard]]
+        uint32_t consume(uint32_t filled) noexcept {
+            const uint32_t keep = m_batch - filled;
+            for (uint32_t i = 0; i < keep; ++i)
+                m_iov[i] = m_iov[i + filled];
+            return keep;
+        }
+
+        [[nodiscard]]
+        void* buffer(uint32_t i) const noexcept {
+            return m_iov[i].iov_base;
+        }
+
+        [[nodiscard]]
+        uint32_t length(uint32_t i) const noexcept {
+            return m_msgs[i].msg_len;
+        }
+
+        // msghdr do datagrama i (cmsg valido apos receive)
+        [[nodiscard]]
+        const msghdr& header(uint32_t i) const noexcept {
+            return m_msgs[i].msg_hdr;
+        }
+
+        // Datagrama maior que o iovec: kernel cortou o excesso
+        [[nodiscard]]
+        bool truncated(uint32_t i) const noexcept {
+            return (m_msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        }
+
+        [[nodiscard]]
+        uint32_t batch() const noexcept { return m_batch; }
+
+        [[nodiscard]]
+        uint64_t syscalls() const noexcept { return m_syscalls; }
+
+        [[nodiscard]]
+        uint64_t empty_polls() const noexcept { return m_empty_polls; }
+
+        [[nodiscard]]
+        uint64_t packets() const noexcept { return m_packets; }
+
+        // Cormen Cap.17: custo de syscall amortizado por pacote
+        [[nodiscard]]
+        double packets_per_syscall() const noexcept {
+            return m_syscalls
+                ? static_cast<double>(m_packets) / m_syscalls
+                : 0.0;
+        }
+    };
+
+} // namespace petronilho::net
@@ -0,0 +1,221 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// broadcast_ring.hpp - Anel de Difusao 1 Produtor / N Consumidores
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Estilo Disruptor: um unico fluxo de pacotes visto por varios
+// consumidores independentes (persistencia, detector de anomalia,
+// decoder) sem copiar o fluxo uma vez por consumidor.
+//
+//   produtor : sequencia publicada (m_published)
+//   consumidor i : cursor proprio (proxima sequencia a ler)
+//
+// GATING: o produtor so escreve a sequencia s se
+//   s < min(cursores) + Capacity
+// ou seja, nunca sobrescreve um slot que o consumidor mais lento
+// ainda nao leu. O minimo e cacheado (m_gate) e so e recalculado
+// quando o cache diz que falta espaco.
+//
+// LOTE: try_claim(n) reserva ate n slots; o produtor preenche e
+// publish(k) torna os k visiveis com UM store release. Do lado do
+// consumidor, consume() le o cursor publicado uma vez e avanca o
+// proprio cursor uma vez por lote.
+//
+// MEMORIA: slots contiguos, fornecidos pelo chamador ou carvados
+// da ScalableArena (init). slot(seq) = slots[seq & MASK]: o indice
+// e a referencia, como o Handle da Arena.
+//
+// DIFERENCA vs NetworkQueue:
+// NetworkQueue: SPSC, dequeue consome para todos.
+// BroadcastRing: cada consumidor tem seu cursor; o slot so volta
+// ao produtor quando TODOS passaram por ele.
+//
+// ALGORITMO: Fila Circular com Multiplos Cursores de Leitura
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas circulares
+//               Cormen Cap.9 - Minimo (estatistica de ordem)
+// O "head" da fila do Cormen vira o minimo dos N cursores
+// (Cormen Cap.9: minimo em n-1 comparacoes).
+//
+// Complexidade: claim O(1) amortizado (O(N) ao recalcular gate),
+//               publish O(1), consume O(k)
+// Thread-safety: 1 produtor; cada cursor com 1 consumidor
+// ================================================================
+
+#pragma once
+#include "arena.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace petronilho::net {
+
+    template<typename T, size_t Capacity, uint32_t MaxConsumers>
+    class BroadcastRing {
+    private:
+        static_assert((Capacity & (Capacity - 1)) == 0,
+            "Capacity deve ser potencia de 2");
+        static_assert(Capacity >= 2, "Capacity minimo e 2");
+        static_assert(MaxConsumers >= 1, "MaxConsumers minimo e 1");
+
+        static constexpr uint64_t MASK = Capacity - 1;
+
+        // Um cursor por cache line: consumidores nao se invalidam
+        struct alignas(64) Cursor {
+            std::atomic<uint64_t> next{0};
+        };
+
+        // Lado do produtor
+        alignas(64) std::atomic<uint64_t> m_published;  // seqs < m_published visiveis
+        alignas(64) uint64_t m_claimed;                 // proxima seq a reservar
+        uint64_t             m_gate;                    // cache de min(cursores)
+
+        Cursor   m_cursors[MaxConsumers];
+        T*       m_slots;
+        uint32_t m_consumers;
+
+        // Cormen Cap.9: minimo dos n primeiros cursores, n-1 comparacoes
+        [[nodiscard]]
+        uint64_t slowest(uint32_t n) const noexcept {
+            uint64_t min = m_cursors[0].next.load(std::memory_order_acquire);
+            for (uint32_t i = 1; i < n; ++i) {
+                const uint64_t c = m_cursors[i].next.load(std::memory_order_acquire);
+                if (c < min) min = c;
+            }
+            return min;
+        }
+
+    public:
+        BroadcastRing() noexcept
+            : m_published(0), m_claimed(0), m_gate(0)
+            , m_slots(nullptr), m_consumers(0) {}
+
+        BroadcastRing(const BroadcastRing&)            = delete;
+        BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+        // Slots fornecidos pelo chamador (Capacity elementos)
+        [[nodiscard]]
+        bool init(T* slots, uint32_t consumers) noexcept {
+            if (!slots || consumers == 0 || consumers > MaxConsumers)
+                return false;
+            m_slots     = slots;
+            m_consumers = consumers;
+            return true;
+        }
+
+        // Slots carvados da ScalableArena
+        [[nodiscard]]
+        bool init(sys::ScalableArena& arena, uint32_t consumers) noexcept {
+            auto h = arena.allocate<T>(Capacity, sys::ArenaTag::NET);
+            if (h.is_null()) return false;
+            return init(h.get_ptr(), consumers);
+        }
+
+        // ============================================================
+        // try_claim - Reserva ate n slots (PRODUTOR)
+        //
+        // Retorna quantos foram concedidos (0 = anel cheio pelo
+        // consumidor mais lento); first recebe a primeira sequencia.
+        // ============================================================
+        [[nodiscard]]
+        uint32_t try_claim(uint32_t n, uint64_t& first) noexcept {
+            uint64_t room = m_gate + Capacity - m_claimed;
+            if (room < n) {
+                m_gate = slowest(m_consumers);
+                room   = m_gate + Capacity - m_claimed;
+            }
+            const uint32_t granted = room < n ? static_cast<uint32_t>(room) : n;
+            first      = m_claimed;
+            m_claimed += granted;
+            return granted;
+        }
+
+        // Torna visiveis os proximos k slots reservados (PRODUTOR)
+        void publish(uint32_t k) noexcept {
+            const uint64_t p = m_published.load(std::memory_order_relaxed);
+            m_published.store(p + k, std::memory_order_release);
+        }
+
+        // Atalho: claim + copia + publish de um elemento
+        [[nodiscard]]
+        bool try_publish(const T& value) noexcept {
+            uint64_t seq;
+            if (try_claim(1, seq) == 0) return false;
+            m_slots[seq & MASK] = value;
+            publish(1);
+            return true;
+        }
+
+        [[nodiscard]]
+        T& slot(uint64_t seq) noexcept { return m_slots[seq & MASK]; }
+
+        [[nodiscard]]
+        const T& slot(uint64_t seq) const noexcept { return m_slots[seq & MASK]; }
+
+        // Indice do slot na memoria contigua (referencia estavel)
+        [[nodiscard]]
+        static uint32_t index_of(uint64_t seq) noexcept {
+            return static_cast<uint32_t>(seq & MASK);
+        }
+
+        // ============================================================
+        // consume - Le ate max elementos novos para o consumidor c
+        //
+        // on_item(const T&, uint64_t seq) por elemento, em ordem.
+        // O cursor avanca uma vez ao fim do lote (release), o que
+        // libera os slots para o produtor.
+        // upto: barreira de dependencia (Disruptor): so le seqs
+        // abaixo dela, ex.: gate(k) = depois dos consumidores 0..k-1.
+        // Retorna o numero de elementos lidos.
+        // ============================================================
+        template<typename OnItem>
+        uint32_t consume(uint32_t c, OnItem&& on_item,
+                         uint32_t max  = 0xFFFFFFFFu,
+                         uint64_t upto = ~uint64_t(0)) noexcept {
+            const uint64_t next = m_cursors[c].next.load(std::memory_order_relaxed);
+            const uint64_t pub  = m_published.load(std::memory_order_acquire);
+            const uint64_t end  = pub < upto ? pub : upto;
+            if (end <= next) return 0;
+            uint64_t avail = end - next;
+            if (avail > max) avail = max;
+
+            for (uint64_t s = next; s < next + avail; ++s)
+                on_item(m_slots[s & MASK], s);
+
+            m_cursors[c].next.store(next + avail, std::memory_order_release);
+            return static_cast<uint32_t>(avail);
+        }
+
+        [[nodiscard]]
+        bool try_read(uint32_t c, T& out) noexcept {
+            return consume(c, [&out](const T& v, uint64_t) { out = v; }, 1) == 1;
+        }
+
+        // Sequencias publicadas que o consumidor c ainda nao leu
+        [[nodiscard]]
+        uint64_t lag(uint32_t c) const noexcept {
+            return m_published.load(std::memory_order_acquire)
+                 - m_cursors[c].next.load(std::memory_order_acquire);
+        }
+
+        // Os consumidores 0..n-1 ja passaram de seqs < retorno
+        [[nodiscard]]
+        uint64_t gate(uint32_t n) const noexcept { return slowest(n); }
+
+        [[nodiscard]]
+        uint64_t gate() const noexcept { return slowest(m_consumers); }
+
+        [[nodiscard]]
+        uint64_t published() const noexcept {
+            return m_published.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]]
+        uint32_t consumers() const noexcept { return m_consumers; }
+
+        [[nodiscard]]
+        static constexpr size_t capacity() noexcept { return Capacity; }
+    };
+
+} // namespace petronilho::net
@@ -0,0 +1,185 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// event_count.hpp - Eventcount com Futex (Estacionar o Consumidor)
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Consumidores de NetworkQueue, MpscQueue e RingBuffer esperam
+// dado novo girando em pop(): latencia minima, mas 100% de um
+// nucleo mesmo com o mercado fechado. EventCount deixa o
+// consumidor girar por um orcamento curto e depois dormir num
+// futex; o produtor so acorda alguem se houver alguem dormindo.
+//
+//   consumidor:                     produtor:
+//     key = prepare_wait()            fila.enqueue(x)
+//     if (fila tem dado)              ec.notify()
+//         cancel_wait()
+//     else commit_wait(key)
+//
+// CUSTO NO PRODUTOR: notify() e uma leitura relaxed de m_waiters
+// quando ninguem esta estacionado. Nenhum RMW, nenhuma syscall.
+//
+// POR QUE NAO PERDE WAKEUP:
+// O consumidor incrementa m_waiters e DEPOIS confere a fila; o
+// produtor publica na fila e DEPOIS le m_waiters. Os dois pares
+// store->load precisam de barreira StoreLoad (senao os dois leem
+// o valor antigo e o consumidor dorme com dado na fila). A
+// barreira pesada fica so no consumidor, que ja vai dormir:
+// membarrier(PRIVATE_EXPEDITED) forca uma barreira completa em
+// todas as threads do processo, e o produtor fica so com uma
+// barreira de compilador. Sem membarrier (kernel < 4.14 ou
+// seccomp), os dois lados pagam atomic_thread_fence(seq_cst).
+// Quem confere a fila depois do incremento ve o dado; quem nao
+// ve, o produtor ve m_waiters != 0, avanca m_epoch e chama
+// FUTEX_WAKE. commit_wait dorme so se m_epoch ainda for key:
+// um notify entre prepare e commit faz o futex voltar na hora.
+//
+// ALGORITMO: Eventcount (Dekker assimetrico + futex)
+// BASE TEORICA: Cormen Cap.17 - Analise Amortizada
+// O spin cobre rajadas (o caso comum sob carga); so o ocioso
+// paga a syscall de dormir, amortizada pelo tempo dormido. O
+// produtor paga O(1) por notify, e a syscall de acordar so
+// quando houve quem dormisse.
+//
+// Complexidade: notify O(1); await spin O(spins) + bloqueio
+// Thread-safety: N produtores, N consumidores
+// ================================================================
+
+#pragma once
+#include "core/platform/platform_detect.hpp"
+#include <atomic>
+#include <cstdint>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace petronilho::sys {
+
+    namespace detail {
+        // Registro unico por processo. true: barreira pesada via
+        // membarrier disponivel
+        inline bool membarrier_ready() noexcept {
+            static const bool ready = [] {
+            #if defined(__NR_membarrier)
+                const long cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+                if (cmds < 0 || !(cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) return false;
+                return syscall(__NR_membarrier,
+                               MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+            #else
+                return false;
+            #endif
+            }();
+            return ready;
+        }
+    }
+
+    class EventCount {
+    private:
+        alignas(64) std::atomic<uint32_t> m_epoch;     // palavra do futex
+        std::atomic<uint32_t>             m_waiters;   // estacionados ou prestes
+        alignas(64) std::atomic<uint64_t> m_parks;     // lado do consumidor
+        const bool                        m_asymmetric;
+
+        void heavy_barrier() noexcept {
+        #if defined(__NR_membarrier)
+            if (m_asymmetric &&
+                syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) == 0)
+                return;
+        #endif
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        PETRONILHO_FORCE_INLINE void light_barrier() const noexcept {
+            if (m_asymmetric) std::atomic_signal_fence(std::memory_order_seq_cst);
+            else              std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        void wake() noexcept {
+            m_epoch.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex, &m_epoch, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+    public:
+        EventCount() noexcept
+            : m_epoch(0), m_waiters(0), m_parks(0),
+              m_asymmetric(detail::membarrier_ready()) {}
+
+        EventCount(const EventCount&)            = delete;
+        EventCount& operator=(const EventCount&) = delete;
+
+        // ============================================================
+        // notify - chamar DEPOIS de publicar (PRODUTOR)
+        // Ninguem estacionado: uma leitura relaxed
+        // ============================================================
+        PETRONILHO_FORCE_INLINE void notify() noexcept {
+            light_barrier();
+            if (m_waiters.load(std::memory_order_relaxed) != 0) [[unlikely]]
+                wake();
+        }
+
+        // Acorda sem conferir m_waiters (desligamento)
+        void notify_all() noexcept { wake(); }
+
+        // ============================================================
+        // prepare_wait / cancel_wait / commit_wait (CONSUMIDOR)
+        // Entre prepare e commit, conferir a condicao de novo.
+        // ============================================================
+        [[nodiscard]]
+        uint32_t prepare_wait() noexcept {
+            m_waiters.fetch_add(1, std::memory_order_relaxed);
+            heavy_barrier();
+            return m_epoch.load(std::memory_order_acquire);
+        }
+
+        void cancel_wait() noexcept {
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // timeout_ns = 0: sem limite. Pode voltar sem notify
+        // (timeout, sinal); o chamador confere a condicao.
+        void commit_wait(uint32_t key, uint64_t timeout_ns = 0) noexcept {
+            struct timespec ts;
+            ts.tv_sec  = static_cast<time_t>(timeout_ns / 1000000000ULL);
+            ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000ULL);
+            m_parks.fetch_add(1, std::memory_order_relaxed);
+            syscall(SYS_futex, &m_epoch, FUTEX_WAIT_PRIVATE, key,
+                    timeout_ns ? &ts : nullptr, nullptr, 0);
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // ============================================================
+        // await - spin ate spins tentativas, depois estaciona
+        // ready(): a condicao (ex.: !fila.empty()). true: ficou
+        // pronta; false: timeout_ns passou sem dado (0 = sem limite,
+        // cada volta dorme de novo ate um notify).
+        // ============================================================
+        template<typename Ready>
+        [[nodiscard]]
+        bool await(Ready&& ready, uint32_t spins = 4096, uint64_t timeout_ns = 0) noexcept {
+            for (uint32_t i = 0; i < spins; ++i) {
+                if (ready()) return true;
+                _mm_pause();
+            }
+            for (;;) {
+                const uint32_t key = prepare_wait();
+                if (ready()) { cancel_wait(); return true; }
+                commit_wait(key, timeout_ns);
+                if (ready()) return true;
+                if (timeout_ns) return false;
+            }
+        }
+
+        // Vezes que um consumidor dormiu no futex
+        [[nodiscard]]
+        uint64_t parks() const noexcept { return m_parks.load(std::memory_order_relaxed); }
+
+        // true: notify() sem barreira de CPU (membarrier registrado)
+        [[nodiscard]]
+        bool asymmetric() const noexcept { return m_asymmetric; }
+    };
+
+} // namespace petronilho::sys
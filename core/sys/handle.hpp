@@ -1,4 +1,4 @@
-// Layer: L0 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+// Layer: L0 | Version: 1.2.0 | Author: Fabio Petronilho de Oliveira
 //
 // ================================================================
 // handle.hpp - Handle de Offset Relativo ao Pool
@@ -22,9 +22,17 @@
 // G_POOL_BASE global removido. Cada Handle agora carrega
 // referencia ao seu proprio pool, eliminando acoplamento
 // invisivel que causaria bugs silenciosos com multiplos pools.
+//
+// v1.2: WideHandle<T> (SegmentedArena)
+// m_index de 32 bits limita o pool a 4GB. WideHandle guarda
+// segmento (16 bits) + offset (48 bits) num uint64_t e resolve
+// pela tabela de segmentos da arena: os segmentos nunca se movem,
+// entao a tabela so cresce. Handle<T> continua para estruturas
+// que cabem em 4GB (12 bytes, sem indirecao extra).
 // ================================================================
 
 #pragma once
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 
@@ -70,4 +78,56 @@ namespace petronilho::sys {
         }
     };
 
+    // ============================================================
+    // WideHandle - segmento + offset de 48 bits (SegmentedArena)
+    // get_ptr: uma leitura na tabela de segmentos e uma soma
+    // ============================================================
+    static constexpr uint64_t WIDE_HANDLE_NULL  = ~uint64_t(0);
+    static constexpr uint32_t WIDE_OFFSET_BITS  = 48;
+    static constexpr uint64_t WIDE_OFFSET_MASK  = (uint64_t(1) << WIDE_OFFSET_BITS) - 1;
+
+    template<typename T>
+    struct WideHandle {
+        uint64_t                     m_ref;       // segmento << 48 | offset
+        const std::atomic<uint8_t*>* m_segments;  // tabela da arena dona
+
+        [[nodiscard]]
+        static constexpr uint64_t make_ref(uint32_t segment, uint64_t offset) noexcept {
+            return (uint64_t(segment) << WIDE_OFFSET_BITS) | (offset & WIDE_OFFSET_MASK);
+        }
+
+        [[nodiscard]]
+        uint32_t segment() const noexcept {
+            return static_cast<uint32_t>(m_ref >> WIDE_OFFSET_BITS);
+        }
+
+        [[nodiscard]]
+        uint64_t offset() const noexcept { return m_ref & WIDE_OFFSET_MASK; }
+
+        [[nodiscard]]
+        T* get_ptr() const noexcept {
+            if (m_ref == WIDE_HANDLE_NULL || !m_segments)
+                return nullptr;
+            uint8_t* base = m_segments[segment()].load(std::memory_order_acquire);
+            return reinterpret_cast<T*>(base + offset());
+        }
+
+        T& operator*()  const noexcept { return *get_ptr(); }
+        T* operator->() const noexcept { return get_ptr();  }
+
+        [[nodiscard]]
+        bool is_null() const noexcept {
+            return m_ref == WIDE_HANDLE_NULL || !m_segments;
+        }
+
+        bool operator<(const WideHandle& other) const noexcept {
+            return (*get_ptr()) < (*other.get_ptr());
+        }
+
+        [[nodiscard]]
+        static WideHandle null() noexcept {
+            return WideHandle{ WIDE_HANDLE_NULL, nullptr };
+        }
+    };
+
 } // namespace petronilho::sys
\ No newline at end of file
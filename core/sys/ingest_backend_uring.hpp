@@ -0,0 +1,121 @@
+// Layer: L1 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// ingest_backend_uring.hpp - Backend io_uring do IngestEngine
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Adapta o UringReceiver (recv multishot + buffer ring) ao
+// contrato de backend do IngestEngine. Separado de
+// ingest_backends.hpp para que so quem usa io_uring dependa
+// de liburing.
+//
+// JOURNAL ASSINCRONO (opcional): set_journal(fd)
+// Cada datagrama tambem vira uma escrita io_uring no arquivo, em
+// offsets crescentes. O buffer so volta ao anel quando as duas
+// referencias acabam: escrita concluida E release() do motor.
+//
+// ALGORITMO: Contagem de Referencias por Buffer
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas circulares
+// O buffer ring e uma fila circular; refs[bid] decide quando o
+// slot pode voltar para a cauda da fila.
+//
+// Complexidade: poll O(k) para k CQEs, release O(1)
+// Thread-safety: poll/release na thread dona do io_uring
+// ================================================================
+
+#pragma once
+#include "ingest_engine.hpp"
+#include "uring_receiver.hpp"
+#include <cstdint>
+
+namespace petronilho::net {
+
+    template<uint32_t Entries>
+    class UringBackend {
+    private:
+        // user_data das escritas: tag no alto, bid embaixo
+        static constexpr uint64_t JOURNAL_TAG = 0x2ULL << 32;
+
+        UringReceiver<Entries> m_rx;
+        int                    m_fd;
+        int                    m_journal_fd;
+        uint64_t               m_journal_off;
+        uint64_t               m_journal_errors;
+        uint8_t                m_refs[Entries];
+
+        void unref(uint16_t bid) noexcept {
+            if (--m_refs[bid] == 0) m_rx.recycle(bid);
+        }
+
+    public:
+        static constexpr const char* NAME = "io_uring";
+
+        explicit UringBackend(int fd) noexcept
+            : m_fd(fd), m_journal_fd(-1), m_journal_off(0)
+            , m_journal_errors(0), m_refs{} {}
+
+        // Carva os buffers da Arena e arma o buffer ring
+        [[nodiscard]]
+        bool init(sys::ScalableArena& arena, uint32_t buf_size) noexcept {
+            return m_rx.init(m_fd, arena, buf_size);
+        }
+
+        void set_journal(int fd) noexcept { m_journal_fd = fd; }
+
+        // O fd do io_uring sinaliza CQE pronta: serve ao epoll
+        [[nodiscard]]
+        int wait_fd() noexcept { return m_rx.ring().ring_fd; }
+
+        template<typename Sink>
+        void prepare(Sink&) noexcept {}
+
+        template<typename Sink, typename Emit>
+        PETRONILHO_FORCE_INLINE int poll(Sink&, Emit&& emit) noexcept {
+            int packets = 0;
+            m_rx.reap(
+                [&](uint16_t bid, uint8_t* data, uint32_t len) {
+                    m_refs[bid] = 1;
+                    if (m_journal_fd >= 0) {
+                        io_uring_sqe* sqe = io_uring_get_sqe(&m_rx.ring());
+                        if (sqe) {
+                            io_uring_prep_write(sqe, m_journal_fd, data, len,
+                                                m_journal_off);
+                            io_uring_sqe_set_data64(sqe, JOURNAL_TAG | bid);
+                            m_journal_off += len;
+                            ++m_refs[bid];
+                        } else {
+                            ++m_journal_errors;
+                        }
+                    }
+
+                    Datagram d{};
+                    d.data  = data;
+                    d.len   = len;
+                    d.token = bid;
+                    emit(d);
+                    ++packets;
+                },
+                [&](uint64_t user_data, int res) {
+                    if ((user_data & ~0xFFFFULL) != JOURNAL_TAG) return;
+                    if (res < 0) ++m_journal_errors;
+                    unref(static_cast<uint16_t>(user_data & 0xFFFF));
+                });
+            return packets;
+        }
+
+        void release(const Datagram& d) noexcept {
+            unref(static_cast<uint16_t>(d.token));
+        }
+
+        [[nodiscard]]
+        UringReceiver<Entries>& receiver() noexcept { return m_rx; }
+
+        [[nodiscard]]
+        uint64_t journal_bytes() const noexcept { return m_journal_off; }
+
+        [[nodiscard]]
+        uint64_t journal_errors() const noexcept { return m_journal_errors; }
+    };
+
+} // namespace petronilho::net
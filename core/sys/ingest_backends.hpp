@@ -0,0 +1,221 @@
+// Layer: L1 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// ingest_backends.hpp - Backends de Recepcao do IngestEngine
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Adapta cada forma de tirar datagramas do kernel ao contrato
+// unico do IngestEngine (ver ingest_engine.hpp):
+//
+//   RecvBackend       : recvmsg, 1 datagrama por syscall. Linha
+//                       de base para as comparacoes.
+//   RecvmmsgBackend   : BatchReceiver (recvmmsg), ate N por
+//                       syscall; UDP_GRO opcional (super-buffer
+//                       dividido no lugar).
+//   PacketRingBackend : PacketRing (AF_PACKET TPACKET_V3), sem
+//                       syscall por bloco, payload no anel.
+//   UringBackend      : ingest_backend_uring.hpp (exige liburing).
+//
+// Backends de socket recebem NO LUGAR: o destino de cada
+// datagrama vem de sink.slot(), entao o kernel copia direto para
+// o journal/arena. Backends de anel (AF_PACKET, io_uring) entregam
+// ponteiros para a propria memoria e a recuperam em release().
+//
+// ALGORITMO: Adapter sobre as primitivas de recepcao
+// BASE TEORICA: Cormen Cap.17 - Analise Amortizada
+// O custo de cada syscall/bloco e dividido pelos k datagramas
+// que ele entrega; IngestStats::packets_per_poll mede isso.
+//
+// Complexidade: poll O(k), release O(1)
+// ================================================================
+
+#pragma once
+#include "ingest_engine.hpp"
+#include "batch_receiver.hpp"
+#include "packet_ring.hpp"
+#include "rx_timestamp.hpp"
+#include "udp_gro.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace petronilho::net {
+
+    // ============================================================
+    // RecvBackend - recvmsg, um datagrama por chamada
+    // ============================================================
+    class RecvBackend {
+    private:
+        int      m_fd;
+        int      m_flags;
+        uint32_t m_buf_size;
+        uint8_t* m_slot;
+        iovec    m_iov;
+        msghdr   m_msg;
+        alignas(8) uint8_t m_control[RX_TIMESTAMP_CMSG_SPACE];
+
+    public:
+        static constexpr const char* NAME = "recv";
+
+        explicit RecvBackend(int fd, uint32_t buf_size = 1500,
+                             int flags = 0) noexcept
+            : m_fd(fd), m_flags(flags), m_buf_size(buf_size)
+            , m_slot(nullptr), m_iov{}, m_msg{}
+        {
+            m_msg.msg_iov    = &m_iov;
+            m_msg.msg_iovlen = 1;
+        }
+
+        [[nodiscard]]
+        int wait_fd() const noexcept { return m_fd; }
+
+        template<typename Sink>
+        void prepare(Sink& sink) noexcept {
+            m_slot = static_cast<uint8_t*>(sink.slot(m_buf_size));
+        }
+
+        template<typename Sink, typename Emit>
+        PETRONILHO_FORCE_INLINE int poll(Sink& sink, Emit&& emit) noexcept {
+            m_iov.iov_base       = m_slot;
+            m_iov.iov_len        = m_buf_size;
+            m_msg.msg_control    = m_control;
+            m_msg.msg_controllen = sizeof(m_control);
+
+            const ssize_t n = recvmsg(m_fd, &m_msg, m_flags);
+            if (n < 0)
+                return (errno == EAGAIN || errno == EWOULDBLOCK
+                        || errno == EINTR) ? 0 : -1;
+
+            Datagram d{};
+            d.data     = m_slot;
+            d.len      = static_cast<uint32_t>(n);
+            d.rx_ns    = rx_timestamp_ns(m_msg);
+            d.in_place = 1;
+            emit(d);
+
+            m_slot = static_cast<uint8_t*>(sink.slot(m_buf_size));
+            return 1;
+        }
+
+        void release(const Datagram&) noexcept {}
+    };
+
+    // ============================================================
+    // RecvmmsgBackend - recvmmsg em lote, GRO opcional
+    //
+    // Com GRO, cada slot e um super-buffer de ate 64KB e cada
+    // segmento e emitido no lugar (segment = 0, 1, ...).
+    // ============================================================
+    template<uint32_t MaxBatch>
+    class RecvmmsgBackend {
+    private:
+        BatchReceiver<MaxBatch> m_rx;
+        int                     m_fd;
+        int                     m_flags;
+        uint32_t                m_buf_size;
+        bool                    m_gro;
+
+    public:
+        static constexpr const char* NAME = "recvmmsg";
+
+        explicit RecvmmsgBackend(int fd, uint32_t batch = MaxBatch,
+                                 uint32_t buf_size = 1500,
+                                 int flags = 0) noexcept
+            : m_rx(batch), m_fd(fd), m_flags(flags)
+            , m_buf_size(buf_size), m_gro(false) {}
+
+        // Chamar antes de attach(): slots passam a 64KB
+        [[nodiscard]]
+        bool enable_gro() noexcept {
+            m_gro = enable_udp_gro(m_fd);
+            if (m_gro) m_buf_size = GRO_MAX_MESSAGE;
+            return m_gro;
+        }
+
+        [[nodiscard]]
+        int wait_fd() const noexcept { return m_fd; }
+
+        template<typename Sink>
+        void prepare(Sink& sink) noexcept {
+            m_rx.enable_control();
+            for (uint32_t i = 0; i < m_rx.batch(); ++i)
+                m_rx.set_buffer(i, sink.slot(m_buf_size), m_buf_size);
+        }
+
+        template<typename Sink, typename Emit>
+        PETRONILHO_FORCE_INLINE int poll(Sink& sink, Emit&& emit) noexcept {
+            const int k = m_rx.receive(m_fd, m_flags);
+            if (k <= 0) return k;
+
+            for (int i = 0; i < k; ++i) {
+                Datagram d{};
+                d.rx_ns    = rx_timestamp_ns(m_rx.header(i));
+                d.in_place = 1;
+
+                const uint32_t seg = m_gro ? gro_segment_size(m_rx.header(i)) : 0;
+                for_each_gro_segment(m_rx.buffer(i), m_rx.length(i), seg,
+                    [&](const uint8_t* data, uint32_t len) {
+                        d.data = data;
+                        d.len  = len;
+                        emit(d);
+                        ++d.segment;
+                    });
+            }
+
+            for (uint32_t i = m_rx.consume(static_cast<uint32_t>(k));
+                 i < m_rx.batch(); ++i)
+                m_rx.set_buffer(i, sink.slot(m_buf_size), m_buf_size);
+            return k;
+        }
+
+        void release(const Datagram&) noexcept {}
+
+        [[nodiscard]]
+        const BatchReceiver<MaxBatch>& receiver() const noexcept { return m_rx; }
+
+        [[nodiscard]]
+        bool gro() const noexcept { return m_gro; }
+    };
+
+    // ============================================================
+    // PacketRingBackend - quadros percorridos no anel AF_PACKET
+    // O anel ja deve estar aberto (PacketRing::open).
+    // ============================================================
+    class PacketRingBackend {
+    private:
+        PacketRing& m_ring;
+
+    public:
+        static constexpr const char* NAME = "af_packet";
+
+        explicit PacketRingBackend(PacketRing& ring) noexcept
+            : m_ring(ring) {}
+
+        [[nodiscard]]
+        int wait_fd() const noexcept { return m_ring.fd(); }
+
+        template<typename Sink>
+        void prepare(Sink&) noexcept {}
+
+        // Um bloco por poll: k = datagramas UDP do bloco na porta
+        template<typename Sink, typename Emit>
+        PETRONILHO_FORCE_INLINE int poll(Sink&, Emit&& emit) noexcept {
+            return static_cast<int>(m_ring.poll([&](const PacketDesc& p) {
+                Datagram d{};
+                d.data  = p.payload;
+                d.len   = p.len;
+                d.rx_ns = p.ts_ns;
+                d.token = p.block;
+                emit(d);
+            }));
+        }
+
+        void release(const Datagram& d) noexcept { m_ring.release(d.token); }
+
+        [[nodiscard]]
+        PacketRing& ring() noexcept { return m_ring; }
+    };
+
+} // namespace petronilho::net
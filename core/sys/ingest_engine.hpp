@@ -0,0 +1,177 @@
+// Layer: L1 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// ingest_engine.hpp - Motor de Ingestao Unico (Backend x Sink x Wait)
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Um unico loop de recepcao, montado em tempo de compilacao:
+//
+//   IngestEngine<Backend, Sink, Wait>
+//
+//   Backend (ingest_backends.hpp, ingest_backend_uring.hpp):
+//     RecvBackend, RecvmmsgBackend, UringBackend, PacketRingBackend
+//   Sink (ingest_sinks.hpp):
+//     RingSink, PersistentSink, QueueSink
+//   Wait (wait_strategy.hpp):
+//     SpinWait, BusyPollWait, BlockingWait, AdaptiveWait
+//
+// Toda combinacao passa pelo MESMO step(): mesmo relogio, mesmos
+// contadores (IngestStats), mesmo histograma de latencia. Trocar
+// o backend nao muda uma linha do caminho quente medido, entao os
+// numeros de backends diferentes sao comparaveis lado a lado.
+//
+// CONTRATO DO BACKEND:
+//   NAME, wait_fd(), prepare(sink)
+//   poll(sink, emit) -> k > 0 mensagens, 0 vazio, -1 erro;
+//                       chama emit(Datagram&) por datagrama
+//   release(d)       -> devolve a memoria do datagrama
+// CONTRATO DO SINK:
+//   NAME, HOLDS
+//   slot(cap)        -> destino para recepcao no lugar
+//   publish(d)       -> false se cheio (conta como descarte)
+//   HOLDS = true: o sink segura d ate o consumidor devolver;
+//   drain_returns(f) entrega as devolucoes ao backend.
+//   pump() (opcional): chamado a cada passo; politicas de
+//   transbordo (backpressure.hpp) drenam o excedente aqui.
+//
+// LATENCIA: carimbo RX do kernel quando o backend tem (recvmmsg,
+// AF_PACKET); sem carimbo, duracao da chamada de poll.
+//
+// ALGORITMO: Composicao Estatica (templates) + Loop Unico
+// BASE TEORICA: Cormen Cap.17 - Analise Amortizada
+// Relogio e contadores sao lidos uma vez por poll, nao por pacote:
+// o custo de instrumentacao e dividido pelo lote.
+//
+// Complexidade: step O(k) para k datagramas entregues
+// ================================================================
+
+#pragma once
+#include "rx_timestamp.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <cstdint>
+#include <cstddef>
+
+namespace petronilho::net {
+
+    // Datagrama entregue pelo backend ao sink (40 bytes)
+    struct Datagram {
+        const uint8_t* data;
+        uint64_t       rx_ns;     // carimbo RX do kernel (0 = sem)
+        uint64_t       seq;       // ordem de chegada no motor
+        uint32_t       len;
+        uint32_t       lat_ns;    // kernel->usuario ou duracao do poll
+        uint32_t       token;     // bid io_uring / bloco AF_PACKET
+        uint16_t       segment;   // indice do segmento GRO (0 = primeiro)
+        uint8_t        in_place;  // data mora num slot de sink.slot()
+        uint8_t        _pad;
+    };
+
+    struct IngestStats {
+        uint64_t polls      = 0;  // chamadas ao backend
+        uint64_t productive = 0;  // polls com >= 1 mensagem
+        uint64_t errors     = 0;  // polls com erro real
+        uint64_t messages   = 0;  // mensagens (super-buffer GRO = 1)
+        uint64_t packets    = 0;  // datagramas entregues ao sink
+        uint64_t bytes      = 0;
+        uint64_t dropped    = 0;  // sink cheio
+
+        // Cormen Cap.17: datagramas por poll produtivo
+        [[nodiscard]]
+        double packets_per_poll() const noexcept {
+            return productive
+                ? static_cast<double>(packets) / productive
+                : 0.0;
+        }
+    };
+
+    template<typename Backend, typename Sink, typename Wait>
+    class IngestEngine {
+    private:
+        Backend&    m_backend;
+        Sink&       m_sink;
+        Wait&       m_wait;
+        IngestStats m_stats;
+
+    public:
+        IngestEngine(Backend& backend, Sink& sink, Wait& wait) noexcept
+            : m_backend(backend), m_sink(sink), m_wait(wait) {}
+
+        IngestEngine(const IngestEngine&)            = delete;
+        IngestEngine& operator=(const IngestEngine&) = delete;
+
+        // ============================================================
+        // attach - Backend pede os primeiros slots ao sink e a
+        // estrategia de espera se prende ao fd do backend.
+        // Retorna false se a espera ficou parcial (ex.: busy-poll
+        // sem CAP_NET_ADMIN); o motor funciona mesmo assim.
+        // ============================================================
+        [[nodiscard]]
+        bool attach() noexcept {
+            m_backend.prepare(m_sink);
+            return m_wait.attach(m_backend.wait_fd());
+        }
+
+        // ============================================================
+        // step - Um poll do backend. Retorna mensagens recebidas.
+        // ============================================================
+        PETRONILHO_FORCE_INLINE int step() noexcept {
+            if constexpr (Sink::HOLDS)
+                m_sink.drain_returns([this](const Datagram& d) {
+                    m_backend.release(d);
+                });
+            if constexpr (requires { m_sink.pump(); })
+                m_sink.pump();
+
+            ++m_stats.polls;
+            const uint64_t t0 = realtime_ns();
+            uint64_t now = 0;
+
+            const int k = m_backend.poll(m_sink, [&](Datagram& d) {
+                // Relogio lido uma vez por poll, no primeiro datagrama
+                if (now == 0) now = realtime_ns();
+                d.seq    = m_stats.packets;
+                d.lat_ns = static_cast<uint32_t>(d.rx_ns
+                    ? (now > d.rx_ns ? now - d.rx_ns : 0)
+                    : now - t0);
+                m_wait.histogram().record(d.lat_ns);
+
+                const bool ok = m_sink.publish(d);
+                if (!ok) ++m_stats.dropped;
+                if (!Sink::HOLDS || !ok) m_backend.release(d);
+
+                ++m_stats.packets;
+                m_stats.bytes += d.len;
+            });
+
+            if (k > 0) {
+                ++m_stats.productive;
+                m_stats.messages += static_cast<uint64_t>(k);
+                m_wait.on_data(static_cast<uint32_t>(k));
+            } else {
+                if (k < 0) ++m_stats.errors;
+                m_wait.idle();
+            }
+            return k;
+        }
+
+        // Roda ate running() devolver false
+        template<typename Running>
+        void run(Running&& running) noexcept {
+            while (running()) step();
+        }
+
+        [[nodiscard]]
+        const IngestStats& stats() const noexcept { return m_stats; }
+
+        [[nodiscard]]
+        Backend& backend() noexcept { return m_backend; }
+
+        [[nodiscard]]
+        Sink& sink() noexcept { return m_sink; }
+
+        [[nodiscard]]
+        Wait& wait() noexcept { return m_wait; }
+    };
+
+} // namespace petronilho::net
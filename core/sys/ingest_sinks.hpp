@@ -0,0 +1,525 @@
+// Layer: L1 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// ingest_sinks.hpp - Destinos (Sinks) do IngestEngine
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Adapta cada destino de dados ao contrato unico do IngestEngine
+// (ver ingest_engine.hpp):
+//
+//   RingSink       : RingBuffer mmap (FIXED: 40 bytes de payload
+//                    por slot, 32 com RECOVER; VARIABLE: payload
+//                    inteiro). Slots de
+//                    recepcao giram numa area de rascunho fornecida
+//                    pelo chamador.
+//   RingDirectSink : recepcao direto no RingBuffer VARIABLE: slot()
+//                    e uma reserva no mmap, publish() o commit.
+//                    Nenhuma copia entre o kernel e o anel.
+//   PersistentSink : journal na PersistentArena. Cada registro e
+//                    JournalRecord + payload; backends de socket
+//                    recebem direto apos o cabecalho (zero copia),
+//                    backends de anel sao copiados uma vez aqui.
+//   QueueSink      : publica o Datagram numa NetworkQueue para a
+//                    thread de logica. O payload continua onde o
+//                    backend o pos; o consumidor devolve com done().
+//                    Slots no lugar vem de um RxSlots (rx_slots.hpp)
+//                    e so voltam ao backend apos o done().
+//   BroadcastSink  : publica o Datagram num BroadcastRing lido por
+//                    N consumidores; o payload volta ao backend
+//                    quando o mais lento passou por ele.
+//
+// TRANSBORDO (RingSink, QueueSink):
+// O segundo parametro de template e a politica de backpressure.hpp
+// (DropNewest por padrao). O sink so oferece as operacoes
+// try_push/overwrite/can_copy/copied/restore; a politica decide.
+// pump() e chamado pelo motor a cada passo (drena o Spill).
+//
+// FORMATO DO JOURNAL (PersistentSink):
+//   [JournalRecord 24B][payload_len bytes] ... alinhado a 64B
+//   segment_size > 0: payload e um super-buffer GRO; segmentos
+//   de segment_size bytes, o ultimo pode ser menor.
+//
+// ALGORITMO: Alocacao Sequencial (bump) com Reinicio Circular
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas circulares
+// Arena cheia volta ao inicio: o journal se comporta como uma
+// fila circular cujo consumidor e o disco (msync/page cache).
+//
+// Complexidade: slot O(1), publish O(1) (+ O(len) se copia)
+// ================================================================
+
+#pragma once
+#include "ingest_engine.hpp"
+#include "backpressure.hpp"
+#include "arena.hpp"
+#include "broadcast_ring.hpp"
+#include "rx_slots.hpp"
+#include "event_count.hpp"
+#include "network_queue.hpp"
+#include "persistent_arena.hpp"
+#include "ring_buffer.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace petronilho::net {
+
+    // ============================================================
+    // RingSink - RingBuffer mmap (uma copia; truncada em FIXED)
+    // scratch >= 2 * lote * cap: slots ainda nao preenchidos que o
+    // backend guardou nunca sao reentregues antes de publicados.
+    // ============================================================
+    template<typename Policy = DropNewest>
+    class RingSink {
+    private:
+        RingBuffer& m_ring;
+        uint8_t*    m_scratch;
+        size_t      m_bytes;
+        size_t      m_next;
+        Policy      m_policy;
+
+    public:
+        static constexpr const char* NAME  = "ring";
+        static constexpr bool        HOLDS = false;
+
+        RingSink(RingBuffer& ring, void* scratch, size_t bytes,
+                 Policy policy = Policy()) noexcept
+            : m_ring(ring), m_scratch(static_cast<uint8_t*>(scratch))
+            , m_bytes(bytes), m_next(0), m_policy(policy) {}
+
+        [[nodiscard]]
+        void* slot(uint32_t cap) noexcept {
+            if (m_next + cap > m_bytes) m_next = 0;
+            void* p = m_scratch + m_next;
+            m_next += (cap + 63) & ~size_t(63);
+            return p;
+        }
+
+        PETRONILHO_FORCE_INLINE bool publish(const Datagram& d) noexcept {
+            return m_policy.admit(d, *this);
+        }
+
+        PETRONILHO_FORCE_INLINE void pump() noexcept { (void)m_policy.pump(*this); }
+
+        // --- Operacoes para a politica (backpressure.hpp) ---
+
+        PETRONILHO_FORCE_INLINE bool try_push(const Datagram& d) noexcept {
+            const uint64_t ts = d.rx_ns ? d.rx_ns : realtime_ns();
+            return m_ring.write(ts, d.lat_ns, static_cast<uint32_t>(d.seq),
+                                d.data, d.len);
+        }
+
+        // Anel criado sem RingOverflow::OVERWRITE: nao ha o que
+        // descartar, a politica conta o novo como perdido
+        bool overwrite(const Datagram& d) noexcept {
+            if (!m_ring.overwrites()) return false;
+            const uint64_t ts = d.rx_ns ? d.rx_ns : realtime_ns();
+            (void)m_ring.write_overwrite(ts, d.lat_ns, static_cast<uint32_t>(d.seq),
+                                         d.data, d.len);
+            return true;
+        }
+
+        // O motor sempre devolve o original (HOLDS = false)
+        [[nodiscard]]
+        bool can_copy() const noexcept { return true; }
+
+        void copied(const Datagram&) noexcept {}
+
+        bool restore(const Datagram& d) noexcept { return try_push(d); }
+
+        [[nodiscard]]
+        RingBuffer& ring() noexcept { return m_ring; }
+
+        [[nodiscard]]
+        Policy& policy() noexcept { return m_policy; }
+    };
+
+    // ============================================================
+    // RingDirectSink - recv/recvmmsg escrevem direto no anel
+    //
+    // slot(cap) = ring.reserve(cap); publish(d) = ring.commit().
+    // O backend pede slots e os preenche na mesma ordem, entao as
+    // reservas fecham em FIFO como o RingBuffer exige. Anel cheio:
+    // slot() cede um buffer de descarte e o datagrama recebido nele
+    // e descartado (nao pode ser intercalado entre reservas).
+    // Sem GRO: um datagrama por slot.
+    // ============================================================
+    class RingDirectSink {
+    private:
+        RingBuffer& m_ring;
+        uint8_t*    m_discard;
+        size_t      m_bytes;
+        size_t      m_next;
+        uint64_t    m_overflow;
+
+    public:
+        static constexpr const char* NAME  = "ring-direct";
+        static constexpr bool        HOLDS = false;
+
+        RingDirectSink(RingBuffer& ring, void* discard, size_t bytes) noexcept
+            : m_ring(ring), m_discard(static_cast<uint8_t*>(discard))
+            , m_bytes(bytes), m_next(0), m_overflow(0) {}
+
+        [[nodiscard]]
+        void* slot(uint32_t cap) noexcept {
+            if (uint8_t* p = m_ring.reserve(cap)) return p;
+            if (m_next + cap > m_bytes) m_next = 0;
+            void* p = m_discard + m_next;
+            m_next += (cap + 63) & ~size_t(63);
+            return p;
+        }
+
+        PETRONILHO_FORCE_INLINE bool publish(const Datagram& d) noexcept {
+            if (d.data != m_ring.pending()) { ++m_overflow; return false; }
+            const uint64_t ts = d.rx_ns ? d.rx_ns : realtime_ns();
+            return m_ring.commit(d.len, ts, d.lat_ns, static_cast<uint32_t>(d.seq));
+        }
+
+        // Datagramas recebidos com o anel cheio
+        [[nodiscard]]
+        uint64_t overflow() const noexcept { return m_overflow; }
+
+        [[nodiscard]]
+        RingBuffer& ring() noexcept { return m_ring; }
+    };
+
+    // Cabecalho de cada registro do journal
+    struct JournalRecord {
+        uint64_t timestamp_ns;  // carimbo RX ou relogio do usuario
+        uint32_t payload_len;
+        uint32_t magic;         // JOURNAL_MAGIC: registro valido
+        uint32_t segment_size;  // 0 = datagrama unico; > 0 = GRO
+        uint32_t latency_ns;
+    };
+
+    static_assert(sizeof(JournalRecord) == 24, "JournalRecord deve ter 24 bytes");
+    static constexpr uint32_t JOURNAL_MAGIC = 0xDEADBEEF;
+
+    // ============================================================
+    // PersistentSink - journal na PersistentArena
+    // ============================================================
+    class PersistentSink {
+    private:
+        PersistentArena& m_arena;
+        JournalRecord*   m_open;    // registro do super-buffer GRO atual
+        uint64_t         m_resets;  // voltas da arena
+
+        [[nodiscard]]
+        uint8_t* reserve(size_t payload) noexcept {
+            void* p = m_arena.allocate(sizeof(JournalRecord) + payload);
+            if (!p) {
+                ++m_resets;
+                m_arena.reset();
+                p = m_arena.allocate(sizeof(JournalRecord) + payload);
+            }
+            return static_cast<uint8_t*>(p);
+        }
+
+        [[nodiscard]]
+        static uint8_t* payload_of(JournalRecord* r) noexcept {
+            return reinterpret_cast<uint8_t*>(r + 1);
+        }
+
+    public:
+        static constexpr const char* NAME  = "persistent";
+        static constexpr bool        HOLDS = false;
+
+        explicit PersistentSink(PersistentArena& arena) noexcept
+            : m_arena(arena), m_open(nullptr), m_resets(0) {}
+
+        // Destino no lugar: logo apos o cabecalho do registro
+        [[nodiscard]]
+        void* slot(uint32_t cap) noexcept {
+            uint8_t* p = reserve(cap);
+            return p ? p + sizeof(JournalRecord) : nullptr;
+        }
+
+        bool publish(const Datagram& d) noexcept {
+            if (d.in_place) {
+                // Segmentos GRO seguintes so estendem o registro aberto
+                if (d.segment != 0 && m_open) {
+                    uint8_t* base = payload_of(m_open);
+                    m_open->payload_len = static_cast<uint32_t>(d.data + d.len - base);
+                    if (d.segment == 1)
+                        m_open->segment_size = static_cast<uint32_t>(d.data - base);
+                    return true;
+                }
+                m_open = reinterpret_cast<JournalRecord*>(
+                    const_cast<uint8_t*>(d.data) - sizeof(JournalRecord));
+            } else {
+                uint8_t* p = reserve(d.len);
+                if (!p) return false;
+                m_open = reinterpret_cast<JournalRecord*>(p);
+                std::memcpy(payload_of(m_open), d.data, d.len);
+            }
+
+            m_open->timestamp_ns = d.rx_ns ? d.rx_ns : realtime_ns();
+            m_open->payload_len  = d.len;
+            m_open->segment_size = 0;
+            m_open->latency_ns   = d.lat_ns;
+            m_open->magic        = JOURNAL_MAGIC;
+            return true;
+        }
+
+        [[nodiscard]]
+        uint64_t resets() const noexcept { return m_resets; }
+    };
+
+    // ============================================================
+    // QueueSink - descritores para a thread de logica
+    //
+    // Produtor: o motor (publish, drain_returns).
+    // Consumidor: pop(d), usa d.data, done(d).
+    // Slots de recepcao no lugar: RxSlots carvado da ScalableArena
+    // no primeiro slot() (Capacity + 256 slots do tamanho pedido,
+    // menos se a Arena nao comporta). Um slot so e reentregue ao
+    // backend depois do done() de todo datagrama nele; com todos
+    // retidos, o datagrama novo e descartado (exhausted()), salvo
+    // se a politica o copia (Spill).
+    //
+    // pop_wait(d) gira um orcamento e depois dorme no EventCount;
+    // publish/pump so acordam se o consumidor estiver dormindo
+    // (uma leitura relaxed a mais por datagrama).
+    //
+    // Originais que a politica descartou (DropOldest) ou copiou
+    // (Spill) esperam em m_stash, na thread do motor, e voltam ao
+    // backend no proximo drain_returns.
+    // ============================================================
+    template<size_t Capacity, typename Policy = DropNewest>
+    class QueueSink {
+    private:
+        static constexpr uint32_t STASH = 1024;
+
+        NetworkQueue<Datagram, Capacity, Policy::OVERWRITES> m_out;
+        NetworkQueue<Datagram, Capacity>                     m_returns;
+        sys::ScalableArena&                                  m_arena;
+        Policy                                               m_policy;
+        Datagram                                             m_stash[STASH];
+        uint32_t                                             m_stashed;
+        RxSlots                                              m_slots;
+        sys::EventCount                                      m_ready;
+
+        // Original que saiu da fila sem passar pelo consumidor
+        void discard(const Datagram& d) noexcept {
+            if (!d.in_place)
+                m_stash[m_stashed++] = d;
+            else if (m_slots.owns(d.data))
+                m_slots.unhold(m_slots.index_of(d.data));
+        }
+
+    public:
+        static constexpr const char* NAME  = "queue";
+        static constexpr bool        HOLDS = true;
+
+        explicit QueueSink(sys::ScalableArena& arena, Policy policy = Policy()) noexcept
+            : m_arena(arena), m_policy(policy), m_stashed(0) {}
+
+        // nullptr: Arena sem espaco para o anel, ou cap maior que o
+        // slot do primeiro pedido
+        [[nodiscard]]
+        void* slot(uint32_t cap) noexcept {
+            if (!m_slots.ready()
+                && !m_slots.init(m_arena, cap, static_cast<uint32_t>(Capacity) + RX_SLOTS_MIN))
+                return nullptr;
+            if (cap > m_slots.slot_bytes()) return nullptr;
+            return m_slots.acquire();
+        }
+
+        PETRONILHO_FORCE_INLINE bool publish(const Datagram& d) noexcept {
+            if (!d.in_place) {
+                const bool ok = m_policy.admit(d, *this);
+                m_ready.notify();
+                return ok;
+            }
+            // Recebido no slot de descarte: todos os slots retidos.
+            // Uma politica que copia (Spill) ainda o guarda
+            if (!m_slots.owns(d.data)) {
+                bool ok = false;
+                if constexpr (Policy::COPIES) ok = m_policy.admit(d, *this);
+                if (ok) m_ready.notify();
+                else    m_slots.refused();
+                return ok;
+            }
+            const uint32_t i = m_slots.publish(d.data, d.segment);
+            const bool ok = m_policy.admit(d, *this);
+            if (!ok) m_slots.unhold(i);
+            m_ready.notify();
+            return ok;
+        }
+
+        PETRONILHO_FORCE_INLINE void pump() noexcept {
+            if (m_policy.pump(*this)) m_ready.notify();
+        }
+
+        template<typename OnReturn>
+        PETRONILHO_FORCE_INLINE void drain_returns(OnReturn&& on_return) noexcept {
+            for (uint32_t i = 0; i < m_stashed; ++i) on_return(m_stash[i]);
+            m_stashed = 0;
+            Datagram d;
+            while (m_returns.dequeue(d)) on_return(d);
+        }
+
+        // --- Operacoes para a politica (backpressure.hpp) ---
+
+        PETRONILHO_FORCE_INLINE bool try_push(const Datagram& d) noexcept {
+            // Slot de descarte: o backend o reusa no proximo datagrama
+            if constexpr (Policy::COPIES)
+                if (d.in_place && !m_slots.owns(d.data)) return false;
+            return m_out.enqueue(d);
+        }
+
+        // Sem espaco no stash o original descartado nao voltaria
+        // ao backend: recusa e a politica descarta o novo
+        bool overwrite(const Datagram& d) noexcept {
+            if constexpr (Policy::OVERWRITES) {
+                if (m_stashed == STASH) return false;
+                Datagram old;
+                if (m_out.enqueue_overwrite(d, old)) discard(old);
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        [[nodiscard]]
+        bool can_copy() const noexcept { return m_stashed < STASH; }
+
+        void copied(const Datagram& d) noexcept { discard(d); }
+
+        // Registro do transbordo volta para um slot do anel. Maior
+        // que o slot: nunca caberia, descartado (exhausted())
+        bool restore(const Datagram& d) noexcept {
+            if (m_out.size() >= Capacity - 1) return false;
+            if (m_slots.ready() && d.len > m_slots.slot_bytes()) {
+                m_slots.refused();
+                return true;
+            }
+            uint8_t* p = static_cast<uint8_t*>(slot(d.len));
+            if (!p || !m_slots.owns(p)) return false;   // todos retidos
+            std::memcpy(p, d.data, d.len);
+            Datagram copy = d;
+            copy.data     = p;
+            copy.in_place = 1;
+            if (m_out.enqueue(copy)) return true;
+            m_slots.unhold(m_slots.index_of(p));   // devolve o emprestimo
+            return false;
+        }
+
+        [[nodiscard]]
+        Policy& policy() noexcept { return m_policy; }
+
+        // --- Lado do consumidor ---
+
+        [[nodiscard]]
+        bool pop(Datagram& d) noexcept { return m_out.dequeue(d); }
+
+        // Fila vazia: spins tentativas, depois dorme ate publish()
+        // ou timeout_ns (0 = sem limite). false: timeout sem dado.
+        [[nodiscard]]
+        bool pop_wait(Datagram& d, uint32_t spins = 4096, uint64_t timeout_ns = 0) noexcept {
+            if (m_out.dequeue(d)) return true;
+            if (!m_ready.await([this] { return !m_out.empty(); }, spins, timeout_ns))
+                return false;
+            return m_out.dequeue(d);
+        }
+
+        // Acorda quem dorme em pop_wait (desligamento: o consumidor
+        // confere a flag de parada no retorno por timeout)
+        void wake() noexcept { m_ready.notify_all(); }
+
+        [[nodiscard]]
+        uint64_t parks() const noexcept { return m_ready.parks(); }
+
+        // Em voo <= Capacity - 1, entao a fila de retorno nao enche.
+        // No lugar: o slot pode voltar ao backend (apos este done,
+        // d.data nao pode mais ser lido)
+        void done(const Datagram& d) noexcept {
+            if (d.in_place) m_slots.release(m_slots.index_of(d.data));
+            else            (void)m_returns.enqueue(d);
+        }
+
+        // Datagramas descartados com todos os slots retidos pelo
+        // consumidor
+        [[nodiscard]]
+        uint64_t exhausted() const noexcept { return m_slots.exhausted(); }
+    };
+
+    // ============================================================
+    // BroadcastSink - um fluxo, N consumidores, nenhuma copia
+    //
+    // Consumidores 0..N-1 leem por ring().consume(c, ...).
+    // O cursor N e interno: drain_returns() o avanca atras de
+    // todos (barreira gate(N)) e devolve os payloads ao backend.
+    // Como e um cursor do anel, o produtor tambem espera por ele:
+    // nenhum slot e reescrito antes de devolvido.
+    // Slots de recepcao no lugar: RxSlots como no QueueSink; o
+    // cursor N os libera quando o mais lento passou pelo datagrama.
+    // ============================================================
+    template<size_t Capacity, uint32_t MaxConsumers>
+    class BroadcastSink {
+    private:
+        BroadcastRing<Datagram, Capacity, MaxConsumers + 1> m_ring;
+        sys::ScalableArena&                                 m_arena;
+        uint32_t                                            m_consumers;
+        RxSlots                                             m_slots;
+
+    public:
+        static constexpr const char* NAME  = "broadcast";
+        static constexpr bool        HOLDS = true;
+
+        explicit BroadcastSink(sys::ScalableArena& arena) noexcept
+            : m_arena(arena), m_consumers(0) {}
+
+        // Slots do anel carvados da Arena
+        [[nodiscard]]
+        bool init(uint32_t consumers) noexcept {
+            if (consumers == 0 || consumers > MaxConsumers) return false;
+            m_consumers = consumers;
+            return m_ring.init(m_arena, consumers + 1);
+        }
+
+        // nullptr: Arena sem espaco para o anel, ou cap maior que o
+        // slot do primeiro pedido
+        [[nodiscard]]
+        void* slot(uint32_t cap) noexcept {
+            if (!m_slots.ready()
+                && !m_slots.init(m_arena, cap, static_cast<uint32_t>(Capacity) + RX_SLOTS_MIN))
+                return nullptr;
+            if (cap > m_slots.slot_bytes()) return nullptr;
+            return m_slots.acquire();
+        }
+
+        PETRONILHO_FORCE_INLINE bool publish(const Datagram& d) noexcept {
+            if (!d.in_place) return m_ring.try_publish(d);
+            // Recebido no slot de descarte: todos os slots retidos
+            if (!m_slots.owns(d.data)) { m_slots.refused(); return false; }
+            const uint32_t i = m_slots.publish(d.data, d.segment);
+            const bool ok = m_ring.try_publish(d);
+            if (!ok) m_slots.unhold(i);
+            return ok;
+        }
+
+        template<typename OnReturn>
+        PETRONILHO_FORCE_INLINE void drain_returns(OnReturn&& on_return) noexcept {
+            m_ring.consume(m_consumers, [&](const Datagram& d, uint64_t) {
+                if (d.in_place) m_slots.release(m_slots.index_of(d.data));
+                else            on_return(d);
+            }, 0xFFFFFFFFu, m_ring.gate(m_consumers));
+        }
+
+        // --- Lado dos consumidores ---
+
+        [[nodiscard]]
+        BroadcastRing<Datagram, Capacity, MaxConsumers + 1>& ring() noexcept {
+            return m_ring;
+        }
+
+        [[nodiscard]]
+        uint32_t consumers() const noexcept { return m_consumers; }
+
+        // Datagramas descartados com todos os slots retidos
+        [[nodiscard]]
+        uint64_t exhausted() const noexcept { return m_slots.exhausted(); }
+    };
+
+} // namespace petronilho::net
@@ -0,0 +1,141 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// latency_histogram.hpp - Histograma Log-Linear de Latencia
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Conta latencias (ns, ciclos, qualquer uint64) em baldes de
+// tamanho fixo, sem alocar e sem ordenar. Cada potencia de 2 e
+// dividida em 16 sub-baldes: erro relativo maximo de 1/16 (~6%)
+// em qualquer ordem de grandeza, de 1 ns a 2^64.
+//
+// DIFERENCA vs ordenar amostras (research_suite):
+// research_suite guarda N amostras e ordena: O(N log N), memoria
+// O(N). Aqui record() e O(1) e a memoria e fixa (~8KB), entao o
+// histograma pode ficar ligado no hot path 24/7.
+//
+// ALGORITMO: Counting Sort com baldes logaritmicos
+// BASE TEORICA: Cormen Cap.8 Sec.8.2 - Counting Sort
+//               Cormen Cap.9 - Order Statistics
+// Cormen Sec.8.2: contar ocorrencias por chave evita comparacoes.
+// O percentil e a estatistica de ordem obtida pela soma
+// acumulada dos contadores (Cormen Cap.9).
+//
+// Complexidade: record O(1), percentile O(B), B = 976 baldes
+// Thread-safety: um escritor; merge() para agregar threads
+// ================================================================
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace petronilho::sys {
+
+    class LatencyHistogram {
+    public:
+        static constexpr uint32_t SUB_BITS = 4;
+        static constexpr uint32_t SUB      = 1u << SUB_BITS;   // 16
+        static constexpr uint32_t BUCKETS  = (64 - SUB_BITS + 1) * SUB;
+
+    private:
+        uint64_t m_counts[BUCKETS];
+        uint64_t m_total;
+        uint64_t m_sum;
+        uint64_t m_min;
+        uint64_t m_max;
+
+        [[nodiscard]]
+        static uint32_t index_of(uint64_t v) noexcept {
+            if (v < SUB) return static_cast<uint32_t>(v);
+            const uint32_t e   = 63u - static_cast<uint32_t>(__builtin_clzll(v));
+            const uint32_t sub = static_cast<uint32_t>(
+                (v >> (e - SUB_BITS)) & (SUB - 1));
+            return (e - SUB_BITS + 1) * SUB + sub;
+        }
+
+        // Menor valor que cai no balde i
+        [[nodiscard]]
+        static uint64_t lower_of(uint32_t i) noexcept {
+            if (i < SUB) return i;
+            const uint32_t e   = i / SUB + SUB_BITS - 1;
+            const uint64_t sub = i % SUB;
+            return (SUB + sub) << (e - SUB_BITS);
+        }
+
+    public:
+        LatencyHistogram() noexcept { reset(); }
+
+        void reset() noexcept {
+            std::memset(m_counts, 0, sizeof(m_counts));
+            m_total = 0;
+            m_sum   = 0;
+            m_min   = ~uint64_t(0);
+            m_max   = 0;
+        }
+
+        // Cormen Sec.8.2: incrementa o contador da chave, O(1)
+        void record(uint64_t v) noexcept {
+            ++m_counts[index_of(v)];
+            ++m_total;
+            m_sum += v;
+            if (v < m_min) m_min = v;
+            if (v > m_max) m_max = v;
+        }
+
+        void merge(const LatencyHistogram& other) noexcept {
+            for (uint32_t i = 0; i < BUCKETS; ++i)
+                m_counts[i] += other.m_counts[i];
+            m_total += other.m_total;
+            m_sum   += other.m_sum;
+            if (other.m_min < m_min) m_min = other.m_min;
+            if (other.m_max > m_max) m_max = other.m_max;
+        }
+
+        // ============================================================
+        // percentile - p em [0, 100]
+        // Cormen Cap.9: estatistica de ordem ceil(p/100 * n) via
+        // soma acumulada. Devolve o ponto medio do balde, limitado
+        // ao maximo observado.
+        // ============================================================
+        [[nodiscard]]
+        uint64_t percentile(double p) const noexcept {
+            if (m_total == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(
+                p / 100.0 * static_cast<double>(m_total) + 0.5);
+            if (rank == 0)       rank = 1;
+            if (rank > m_total)  rank = m_total;
+
+            uint64_t seen = 0;
+            for (uint32_t i = 0; i < BUCKETS; ++i) {
+                seen += m_counts[i];
+                if (seen >= rank) {
+                    const uint64_t lo = lower_of(i);
+                    const uint64_t hi = (i + 1 < BUCKETS)
+                        ? lower_of(i + 1) : m_max;
+                    const uint64_t mid = lo + (hi - lo) / 2;
+                    return mid > m_max ? m_max : mid;
+                }
+            }
+            return m_max;
+        }
+
+        [[nodiscard]]
+        uint64_t count() const noexcept { return m_total; }
+
+        [[nodiscard]]
+        uint64_t min() const noexcept { return m_total ? m_min : 0; }
+
+        [[nodiscard]]
+        uint64_t max() const noexcept { return m_max; }
+
+        [[nodiscard]]
+        double mean() const noexcept {
+            return m_total
+                ? static_cast<double>(m_sum) / static_cast<double>(m_total)
+                : 0.0;
+        }
+    };
+
+} // namespace petronilho::sys
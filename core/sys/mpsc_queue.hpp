@@ -0,0 +1,132 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// mpsc_queue.hpp - Fila Lock-Free Multi Producer Single Consumer
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Varias threads de recepcao (shards) alimentam um unico
+// consumidor (persistencia ou logica). NetworkQueue e SPSC; esta
+// fila aceita N produtores sem lock entre eles.
+//
+// ALGORITMO: Fila Limitada com Sequencia por Slot (Vyukov)
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas
+// Cada slot leva um numero de sequencia que diz de quem ele e:
+//
+//   seq == t        : livre para o produtor do ticket t
+//   seq == t + 1    : preenchido, pronto para o consumidor
+//   seq == t + Cap  : liberado pelo consumidor para a proxima volta
+//
+// O produtor pega o ticket com um unico fetch_add em m_tail: nao
+// ha CAS nem retentativa entre produtores. Depois escreve o valor
+// e publica com store release em seq. O consumidor percorre em
+// ordem de ticket e para no primeiro slot ainda nao publicado.
+//
+// FILA CHEIA: enqueue olha o slot de m_tail antes do fetch_add e
+// recusa se ele ainda nao voltou livre. Produtores que passam pela
+// checagem ao mesmo tempo podem exceder a capacidade em ate
+// (produtores - 1) tickets; esses esperam o consumidor liberar o
+// proprio slot (nunca outro produtor).
+//
+// ORDEM: FIFO por produtor. Entre produtores, ordem dos tickets.
+//
+// Complexidade: enqueue O(1) (um fetch_add), dequeue_batch O(k)
+// com um unico store em m_head por lote
+// ================================================================
+
+#pragma once
+#include "core/platform/platform_detect.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace petronilho::net {
+
+    template<typename T, size_t Capacity>
+    class MpscQueue {
+    private:
+        static_assert((Capacity & (Capacity - 1)) == 0,
+            "Capacity deve ser potencia de 2");
+        static_assert(Capacity >= 2, "Capacity minimo e 2");
+
+        static constexpr size_t MASK = Capacity - 1;
+
+        // Um slot por linha: produtores vizinhos nao disputam linha
+        struct alignas(64) Cell {
+            std::atomic<size_t> seq;
+            T                   value;
+        };
+
+        alignas(64) std::atomic<size_t> m_tail;   // proximo ticket (produtores)
+        alignas(64) std::atomic<size_t> m_head;   // proximo a ler (consumidor)
+        alignas(64) Cell                m_cells[Capacity];
+
+    public:
+        MpscQueue() noexcept : m_tail(0), m_head(0) {
+            for (size_t i = 0; i < Capacity; ++i)
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue&)            = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        // ============================================================
+        // enqueue - Inserir elemento (QUALQUER PRODUTOR)
+        // false: fila cheia, nada foi reservado
+        // ============================================================
+        [[nodiscard]]
+        bool enqueue(const T& value) noexcept {
+            const size_t peek = m_tail.load(std::memory_order_relaxed);
+            const size_t free_seq = m_cells[peek & MASK].seq.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(free_seq - peek) < 0) return false;
+
+            const size_t t = m_tail.fetch_add(1, std::memory_order_relaxed);
+            Cell& c = m_cells[t & MASK];
+            // So espera se outros produtores passaram a checagem junto
+            // e a fila encheu: o consumidor libera este slot
+            while (c.seq.load(std::memory_order_acquire) != t) _mm_pause();
+
+            c.value = value;
+            c.seq.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // ============================================================
+        // dequeue_batch - Ate max elementos em ordem de ticket
+        // (CONSUMIDOR). Cada slot volta livre na hora; m_head e
+        // escrito uma vez por lote.
+        // ============================================================
+        [[nodiscard]]
+        size_t dequeue_batch(T* out, size_t max) noexcept {
+            size_t h = m_head.load(std::memory_order_relaxed);
+            size_t n = 0;
+            while (n < max) {
+                Cell& c = m_cells[h & MASK];
+                if (c.seq.load(std::memory_order_acquire) != h + 1) break;
+                out[n++] = c.value;
+                c.seq.store(h + Capacity, std::memory_order_release);
+                ++h;
+            }
+            if (n) m_head.store(h, std::memory_order_release);
+            return n;
+        }
+
+        [[nodiscard]]
+        bool dequeue(T& out) noexcept { return dequeue_batch(&out, 1) == 1; }
+
+        // Aproximado: tickets pegos menos lidos (inclui os ainda
+        // sendo escritos)
+        [[nodiscard]]
+        size_t size() const noexcept {
+            const size_t h = m_head.load(std::memory_order_acquire);
+            const size_t t = m_tail.load(std::memory_order_acquire);
+            return t > h ? t - h : 0;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept { return size() == 0; }
+
+        static constexpr size_t capacity() noexcept { return Capacity; }
+    };
+
+} // namespace petronilho::net
@@ -1,4 +1,4 @@
-// Layer: L0 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+// Layer: L0 | Version: 1.2.0 | Author: Fabio Petronilho de Oliveira
 //
 // ================================================================
 // network_queue.hpp - Fila Lock-Free Single Producer Single Consumer
@@ -18,7 +18,7 @@
 //
 // RESTRICAO IMPORTANTE: SPSC apenas
 // Single Producer Single Consumer.
-// Para multiplos produtores use arena.hpp com CAS.
+// Para multiplos produtores use mpsc_queue.hpp.
 //
 // CORRECAO vs versao anterior:
 // - memory_order incorreto causava race condition
@@ -26,6 +26,15 @@
 // - dequeue: head com relaxed, tail com acquire
 // - Capacity deve ser potencia de 2 verificado em compile time
 //
+// v1.2: Overwrite (descarta o mais antigo)
+// Com Overwrite = true, enqueue_overwrite() avanca head por CAS
+// quando a fila esta cheia e dequeue() confirma a leitura com CAS:
+// se o produtor descartou o elemento durante a copia, o CAS falha
+// e o consumidor tenta o seguinte (leitura validada, como seqlock).
+// head e tail agora sao contadores de 64 bits sem mascara: o CAS
+// nao sofre ABA quando o indice da a volta no anel.
+// Com Overwrite = false o caminho e o mesmo de antes.
+//
 // Complexidade: O(1) enqueue e dequeue garantido
 // ================================================================
 
@@ -38,7 +47,7 @@
 
 namespace petronilho::net {
 
-    template<typename T, size_t Capacity>
+    template<typename T, size_t Capacity, bool Overwrite = false>
     class NetworkQueue {
     private:
         // Verifica em compilacao que Capacity e potencia de 2
@@ -54,6 +63,7 @@ namespace petronilho::net {
         // Cormen Cap.10: head e tail sao modificados por
         // threads diferentes, separacao evita invalidacao
         // desnecessaria de cache
+        // Contadores monotonicos; o slot e indice & MASK
         alignas(64) std::atomic<size_t> m_head;
         alignas(64) std::atomic<size_t> m_tail;
 
@@ -79,20 +89,43 @@ namespace petronilho::net {
         bool enqueue(const T& value) noexcept {
             const size_t t = m_tail.load(
                 std::memory_order_relaxed);
-            const size_t next = (t + 1) & MASK;
 
-            // Fila cheia: next alcancou head
-            if (next == m_head.load(std::memory_order_acquire))
+            // Fila cheia: Capacity - 1 elementos em voo
+            if (t - m_head.load(std::memory_order_acquire) >= MASK)
                 return false;
 
-            m_buffer[t] = value;
+            m_buffer[t & MASK] = value;
 
             // release: garante que o valor foi escrito
             // antes de atualizar tail
-            m_tail.store(next, std::memory_order_release);
+            m_tail.store(t + 1, std::memory_order_release);
             return true;
         }
 
+        // ============================================================
+        // enqueue_overwrite - Insere sempre (PRODUTOR, Overwrite)
+        //
+        // Cheia: tira o mais antigo por CAS em head e o devolve em
+        // evicted. Retorna true se houve descarte. Se o CAS falha o
+        // consumidor acabou de liberar um slot: nada e descartado.
+        // ============================================================
+        bool enqueue_overwrite(const T& value, T& evicted) noexcept {
+            static_assert(Overwrite, "enqueue_overwrite requer Overwrite = true");
+            const size_t t = m_tail.load(std::memory_order_relaxed);
+            size_t h = m_head.load(std::memory_order_acquire);
+            bool dropped = false;
+
+            if (t - h >= MASK) {
+                evicted = m_buffer[h & MASK];
+                dropped = m_head.compare_exchange_strong(h, h + 1,
+                    std::memory_order_acq_rel, std::memory_order_acquire);
+            }
+
+            m_buffer[t & MASK] = value;
+            m_tail.store(t + 1, std::memory_order_release);
+            return dropped;
+        }
+
         // ============================================================
         // dequeue - Remover elemento (chamado pelo CONSUMIDOR)
         //
@@ -102,6 +135,21 @@ namespace petronilho::net {
         // ============================================================
         [[nodiscard]]
         bool dequeue(T& out) noexcept {
+            if constexpr (Overwrite) {
+                // Produtor tambem move head: valida a copia por CAS
+                size_t h = m_head.load(std::memory_order_acquire);
+                for (;;) {
+                    if (h == m_tail.load(std::memory_order_acquire))
+                        return false;
+                    out = m_buffer[h & MASK];
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (m_head.compare_exchange_weak(h, h + 1,
+                            std::memory_order_acq_rel,
+                            std::memory_order_acquire))
+                        return true;
+                }
+            }
+
             const size_t h = m_head.load(
                 std::memory_order_relaxed);
 
@@ -109,12 +157,11 @@ namespace petronilho::net {
             if (h == m_tail.load(std::memory_order_acquire))
                 return false;
 
-            out = m_buffer[h];
+            out = m_buffer[h & MASK];
 
             // release: garante que lemos o valor antes
             // de liberar o slot para o produtor
-            m_head.store((h + 1) & MASK,
-                std::memory_order_release);
+            m_head.store(h + 1, std::memory_order_release);
             return true;
         }
 
@@ -126,9 +173,10 @@ namespace petronilho::net {
 
         [[nodiscard]]
         size_t size() const noexcept {
-            const size_t t = m_tail.load(std::memory_order_acquire);
+            // head primeiro: tail lido depois nunca fica atras dele
             const size_t h = m_head.load(std::memory_order_acquire);
-            return (t - h) & MASK;
+            const size_t t = m_tail.load(std::memory_order_acquire);
+            return t - h;
         }
     };
 
@@ -0,0 +1,163 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// numa_arena.hpp - Arena com uma Sub-Arena por No NUMA
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Uma ScalableArena por no NUMA, cada uma mapeada com as paginas
+// no proprio no (map_on_node). allocate() manda cada thread para
+// a sub-arena do no em que ela roda; sub-arena local cheia, tenta
+// as dos outros nos antes de devolver null. Handle<T> carrega a
+// base da sub-arena, entao os handles continuam validos e
+// misturaveis entre nos.
+//
+// O no da thread e lido uma vez (getcpu) e guardado em TLS:
+// fixe a CPU da thread antes da primeira alocacao, ou chame
+// initialize_thread() depois de mudar a afinidade.
+//
+// Host de um no: uma sub-arena so, mesmo custo da ScalableArena.
+//
+// Sub-arena i pertence ao i-esimo no online (ids podem ter
+// buracos: nos 0 e 2 sao as sub-arenas 0 e 1). Com mais nos que
+// MAX_NODES, os excedentes dividem sub-arenas remotas (indice %
+// MAX_NODES); unmapped_nodes() diz quantos.
+//
+// ALGORITMO: Particionamento por Localidade + Bump Allocator
+// BASE TEORICA: Cormen Cap.27 - Multithreaded Algorithms
+//               Cormen Cap.17 Sec.17.1 - Aggregate Analysis
+// Cada no aloca da propria particao: o acesso continua local e o
+// custo amortizado por alocacao e o da ScalableArena.
+//
+// Complexidade: allocate O(1) (O(nos) quando o no local enche)
+// ================================================================
+
+#pragma once
+#include "arena.hpp"
+#include "core/platform/numa.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+namespace petronilho::sys {
+
+    class NumaArena {
+    public:
+        // Nos alem deste compartilham sub-arenas (indice % MAX_NODES)
+        static constexpr uint32_t MAX_NODES = 8;
+
+    private:
+        alignas(ScalableArena)
+        uint8_t  m_storage[MAX_NODES][sizeof(ScalableArena)];
+        uint32_t m_nodes;
+        uint32_t m_unmapped;   // nos online sem sub-arena propria
+
+        static thread_local int t_node;
+
+        ScalableArena& sub(uint32_t i) noexcept {
+            return *std::launder(reinterpret_cast<ScalableArena*>(m_storage[i]));
+        }
+
+        const ScalableArena& sub(uint32_t i) const noexcept {
+            return *std::launder(reinterpret_cast<const ScalableArena*>(m_storage[i]));
+        }
+
+        // Sub-arena do no (id); no offline ou desconhecido: 0
+        uint32_t slot_of(int node) const noexcept {
+            const int idx = platform::node_index(node);
+            return idx < 0 ? 0 : static_cast<uint32_t>(idx) % m_nodes;
+        }
+
+        uint32_t local() const noexcept {
+            if (t_node < 0) t_node = platform::current_node();
+            return slot_of(t_node);
+        }
+
+    public:
+        // bytes_per_node em cada no online (total = bytes_per_node * nodes())
+        NumaArena(size_t bytes_per_node, platform::PageHint hint) noexcept
+            : m_nodes(platform::numa_nodes() < MAX_NODES ? platform::numa_nodes() : MAX_NODES)
+            , m_unmapped(platform::numa_nodes() - m_nodes)
+        {
+            const auto& topo  = platform::numa_topology();
+            const bool  multi = m_nodes > 1;
+            for (uint32_t i = 0; i < m_nodes; ++i)
+                ::new (m_storage[i]) ScalableArena(bytes_per_node, hint,
+                                                   multi ? topo.node_id[i] : -1);
+        }
+
+        ~NumaArena() {
+            for (uint32_t i = 0; i < m_nodes; ++i) sub(i).~ScalableArena();
+        }
+
+        NumaArena(const NumaArena&)            = delete;
+        NumaArena& operator=(const NumaArena&) = delete;
+
+        // Esquece o no em cache e os chunks TLS da thread
+        static void initialize_thread() noexcept {
+            t_node = -1;
+            ScalableArena::initialize_thread();
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        Handle<T> allocate(size_t count = 1, ArenaTag tag = ArenaTag::NONE) noexcept {
+            const uint32_t home = local();
+            Handle<T> h = sub(home).template allocate<T>(count, tag);
+            for (uint32_t k = 1; h.is_null() && k < m_nodes; ++k)
+                h = sub((home + k) % m_nodes).template allocate<T>(count, tag);
+            return h;
+        }
+
+        // Recicla todas as sub-arenas (reset por epoca, ver arena.hpp)
+        void reset() noexcept {
+            for (uint32_t i = 0; i < m_nodes; ++i) sub(i).reset();
+        }
+
+        [[nodiscard]]
+        size_t used() const noexcept {
+            size_t u = 0;
+            for (uint32_t i = 0; i < m_nodes; ++i) u += sub(i).used();
+            return u;
+        }
+
+        [[nodiscard]]
+        size_t capacity() const noexcept {
+            size_t c = 0;
+            for (uint32_t i = 0; i < m_nodes; ++i) c += sub(i).capacity();
+            return c;
+        }
+
+        [[nodiscard]]
+        uint32_t nodes() const noexcept { return m_nodes; }
+
+        // Nos online alem de MAX_NODES: alocam da sub-arena de outro
+        // no (memoria remota). 0 = todo no tem a sua
+        [[nodiscard]]
+        uint32_t unmapped_nodes() const noexcept { return m_unmapped; }
+
+        // Sub-arena do no com esse id (para quem espera
+        // ScalableArena&, ex.: sinks)
+        [[nodiscard]]
+        ScalableArena& arena(int node) noexcept { return sub(slot_of(node)); }
+
+        // Sub-arena do no da thread que chama
+        [[nodiscard]]
+        ScalableArena& local_arena() noexcept { return sub(local()); }
+
+        [[nodiscard]]
+        platform::PageSize page_size() const noexcept { return sub(0).page_size(); }
+
+        // Soma dos nos (arena_stats.hpp). Por no: arena(node).stats(),
+        // com o id do no (nao o indice da sub-arena)
+        [[nodiscard]]
+        ArenaStats stats() const noexcept {
+            ArenaStats s;
+            for (uint32_t i = 0; i < m_nodes; ++i) s.add(sub(i).stats());
+            return s;
+        }
+    };
+
+    inline thread_local int NumaArena::t_node = -1;
+
+} // namespace petronilho::sys
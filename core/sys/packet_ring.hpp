@@ -0,0 +1,294 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// packet_ring.hpp - Captura AF_PACKET TPACKET_V3 (mmap, sem copia)
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Backend de ingestao para taps passivos: a pilha UDP fica fora
+// do caminho. O kernel escreve os quadros direto num anel de
+// blocos mapeado (PACKET_RX_RING, TPACKET_V3); o usuario percorre
+// os quadros no lugar, filtra IPv4/UDP/porta e publica
+// descritores (PacketDesc) que apontam para DENTRO do anel.
+// Nenhuma copia acontece ate a persistencia.
+//
+// CICLO DE VIDA DE UM BLOCO:
+//   kernel enche/aposenta -> TP_STATUS_USER -> poll() percorre e
+//   publica descritores -> consumidores chamam release(block) ->
+//   ultimo release devolve TP_STATUS_KERNEL.
+// Cada bloco tem um contador de referencias: 1 do proprio
+// percurso + 1 por descritor publicado. Quem zera devolve o bloco.
+// Consumidor lento segura o bloco; o kernel conta tp_drops.
+//
+// Funciona em lo/veth (bind por interface): da para comparar
+// com o backend de socket na mesma maquina, sem NIC dedicada.
+// Requer CAP_NET_RAW.
+//
+// ALGORITMO: Anel de Blocos + Contagem de Referencias
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas circulares
+// Os blocos formam uma fila circular onde o kernel e produtor
+// e este codigo e consumidor; o dono de cada bloco e decidido
+// pelo campo block_status (equivale a head/tail do Cormen).
+//
+// Complexidade: poll O(q) para q quadros do bloco, release O(1)
+// ================================================================
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace petronilho::net {
+
+    struct PacketRingConfig {
+        const char* ifname        = "lo";
+        uint16_t    udp_port      = 9999;
+        uint32_t    block_size    = 1u << 22;  // 4MB por bloco
+        uint32_t    block_count   = 64;        // 256MB de anel
+        uint32_t    frame_size    = 2048;
+        uint32_t    retire_tov_ms = 10;        // aposenta bloco parcial
+    };
+
+    // Descritor publicado: aponta para o payload UDP dentro do anel
+    struct PacketDesc {
+        const uint8_t* payload;
+        uint32_t       len;
+        uint32_t       block;
+        uint64_t       ts_ns;   // carimbo do kernel (tp_sec/tp_nsec)
+    };
+
+    struct PacketRingStats {
+        uint64_t frames   = 0;  // quadros percorridos
+        uint64_t matched  = 0;  // UDP na porta, publicados
+        uint64_t blocks   = 0;  // blocos percorridos
+        uint64_t k_drops  = 0;  // tp_drops acumulado do kernel
+    };
+
+    class PacketRing {
+    public:
+        static constexpr uint32_t MAX_BLOCKS = 1024;
+
+    private:
+        int                   m_fd;
+        uint8_t*              m_map;
+        size_t                m_map_size;
+        uint32_t              m_block_size;
+        uint32_t              m_block_count;
+        uint32_t              m_current;
+        uint16_t              m_port_be;
+        PacketRingStats       m_stats;
+        std::atomic<uint32_t> m_refs[MAX_BLOCKS];
+
+        [[nodiscard]]
+        tpacket_block_desc* block(uint32_t b) const noexcept {
+            return reinterpret_cast<tpacket_block_desc*>(
+                m_map + static_cast<size_t>(b) * m_block_size);
+        }
+
+        void give_back(uint32_t b) noexcept {
+            __atomic_store_n(&block(b)->hdr.bh1.block_status,
+                             TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        }
+
+        // IPv4 sem fragmento + UDP na porta: devolve payload ou nullptr
+        // Quadro malformado (cabecalho de rede fora do snaplen, IHL
+        // < 5, cabecalhos IP + UDP alem do capturado) e ignorado
+        [[nodiscard]]
+        const uint8_t* match_udp(const tpacket3_hdr* h,
+                                 uint32_t& len) const noexcept {
+            if (h->tp_net < h->tp_mac) return nullptr;
+            const uint32_t net_off = h->tp_net - h->tp_mac;
+            if (net_off > h->tp_snaplen) return nullptr;
+            const uint32_t avail = h->tp_snaplen - net_off;
+            if (avail < sizeof(iphdr) + sizeof(udphdr)) return nullptr;
+
+            const uint8_t* net = reinterpret_cast<const uint8_t*>(h) + h->tp_net;
+            const iphdr* ip = reinterpret_cast<const iphdr*>(net);
+            if (ip->version != 4 || ip->protocol != IPPROTO_UDP) return nullptr;
+            if (ip->ihl < 5) return nullptr;
+            if (ip->frag_off & htons(IP_MF | IP_OFFMASK)) return nullptr;
+
+            const uint32_t ihl = ip->ihl * 4u;
+            if (avail < ihl + sizeof(udphdr)) return nullptr;
+
+            const udphdr* udp = reinterpret_cast<const udphdr*>(net + ihl);
+            if (udp->dest != m_port_be) return nullptr;
+
+            const uint32_t udp_len = ntohs(udp->len);
+            if (udp_len < sizeof(udphdr)) return nullptr;
+            len = udp_len - sizeof(udphdr);
+            if (len > avail - ihl - sizeof(udphdr))
+                len = avail - ihl - sizeof(udphdr);
+            return net + ihl + sizeof(udphdr);
+        }
+
+    public:
+        PacketRing() noexcept
+            : m_fd(-1), m_map(nullptr), m_map_size(0)
+            , m_block_size(0), m_block_count(0), m_current(0), m_port_be(0)
+        {
+            for (uint32_t i = 0; i < MAX_BLOCKS; ++i)
+                m_refs[i].store(0, std::memory_order_relaxed);
+        }
+
+        PacketRing(const PacketRing&)            = delete;
+        PacketRing& operator=(const PacketRing&) = delete;
+
+        ~PacketRing() noexcept {
+            if (m_map) munmap(m_map, m_map_size);
+            if (m_fd >= 0) close(m_fd);
+        }
+
+        // ============================================================
+        // open - socket AF_PACKET + TPACKET_V3 + mmap + bind(ifname)
+        // Retorna false em falha (errno da chamada que falhou) ou se
+        // o anel ja esta aberto (fd e mapeamento atuais seguem valendo).
+        // Socket e mapeamento de um open que falhou sao liberados antes
+        // da nova tentativa
+        // ============================================================
+        [[nodiscard]]
+        bool open(const PacketRingConfig& cfg) noexcept {
+            if (m_block_count) return false;
+            if (m_map) { munmap(m_map, m_map_size); m_map = nullptr; m_map_size = 0; }
+            if (m_fd >= 0) { close(m_fd); m_fd = -1; }
+            if (cfg.block_count == 0 || cfg.block_count > MAX_BLOCKS)
+                return false;
+
+            m_fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IP));
+            if (m_fd < 0) return false;
+
+            int version = TPACKET_V3;
+            if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION,
+                           &version, sizeof(version)) < 0)
+                return false;
+
+            // Em lo cada pacote apareceria 2x (saida + entrada)
+            int one = 1;
+            setsockopt(m_fd, SOL_PACKET, PACKET_IGNORE_OUTGOING,
+                       &one, sizeof(one));
+
+            tpacket_req3 req{};
+            req.tp_block_size       = cfg.block_size;
+            req.tp_block_nr         = cfg.block_count;
+            req.tp_frame_size       = cfg.frame_size;
+            req.tp_frame_nr         = (cfg.block_size / cfg.frame_size)
+                                    * cfg.block_count;
+            req.tp_retire_blk_tov   = cfg.retire_tov_ms;
+            req.tp_sizeof_priv      = 0;
+            req.tp_feature_req_word = 0;
+            if (setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING,
+                           &req, sizeof(req)) < 0)
+                return false;
+
+            m_map_size = static_cast<size_t>(cfg.block_size) * cfg.block_count;
+            void* map = mmap(nullptr, m_map_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, m_fd, 0);
+            if (map == MAP_FAILED) { m_map_size = 0; return false; }
+            m_map = static_cast<uint8_t*>(map);
+
+            sockaddr_ll ll{};
+            ll.sll_family   = AF_PACKET;
+            ll.sll_protocol = htons(ETH_P_IP);
+            ll.sll_ifindex  = static_cast<int>(if_nametoindex(cfg.ifname));
+            if (ll.sll_ifindex == 0) return false;
+            if (bind(m_fd, reinterpret_cast<const sockaddr*>(&ll),
+                     sizeof(ll)) < 0)
+                return false;
+
+            m_block_size  = cfg.block_size;
+            m_block_count = cfg.block_count;
+            m_port_be     = htons(cfg.udp_port);
+            return true;
+        }
+
+        // ============================================================
+        // poll - Percorre o proximo bloco pronto, se houver
+        //
+        // on_packet(const PacketDesc&) para cada UDP na porta.
+        // O descritor segura o bloco ate release(desc.block).
+        // Sem bloco pronto: poll(2) ate timeout_ms (0 = nao espera).
+        // Retorna o numero de descritores publicados.
+        // ============================================================
+        template<typename OnPacket>
+        uint32_t poll(OnPacket&& on_packet, int timeout_ms = 0) noexcept {
+            const uint32_t b = m_current;
+            tpacket_block_desc* bd = block(b);
+
+            if (!(__atomic_load_n(&bd->hdr.bh1.block_status,
+                                  __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+                if (timeout_ms) {
+                    pollfd pfd{ m_fd, POLLIN | POLLERR, 0 };
+                    ::poll(&pfd, 1, timeout_ms);
+                }
+                return 0;
+            }
+
+            // Volta completa com o bloco ainda preso por consumidor:
+            // status continua USER, mas ja foi percorrido
+            if (m_refs[b].load(std::memory_order_acquire) != 0)
+                return 0;
+
+            // Referencia do percurso: bloco nao volta ao kernel no meio
+            m_refs[b].store(1, std::memory_order_relaxed);
+
+            uint32_t published = 0;
+            const uint32_t n   = bd->hdr.bh1.num_pkts;
+            const tpacket3_hdr* h = reinterpret_cast<const tpacket3_hdr*>(
+                reinterpret_cast<const uint8_t*>(bd)
+                + bd->hdr.bh1.offset_to_first_pkt);
+
+            for (uint32_t i = 0; i < n; ++i) {
+                uint32_t len = 0;
+                const uint8_t* payload = match_udp(h, len);
+                if (payload) {
+                    m_refs[b].fetch_add(1, std::memory_order_relaxed);
+                    on_packet(PacketDesc{ payload, len, b,
+                        static_cast<uint64_t>(h->tp_sec) * 1000000000ULL
+                        + h->tp_nsec });
+                    ++published;
+                }
+                h = reinterpret_cast<const tpacket3_hdr*>(
+                    reinterpret_cast<const uint8_t*>(h) + h->tp_next_offset);
+            }
+
+            m_stats.frames  += n;
+            m_stats.matched += published;
+            ++m_stats.blocks;
+
+            m_current = (b + 1) % m_block_count;
+            release(b);  // solta a referencia do percurso
+            return published;
+        }
+
+        // Consumidor terminou com um descritor do bloco
+        void release(uint32_t b) noexcept {
+            if (m_refs[b].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                give_back(b);
+        }
+
+        // Le e acumula tp_drops (a leitura zera o contador do kernel)
+        [[nodiscard]]
+        const PacketRingStats& stats() noexcept {
+            tpacket_stats_v3 st{};
+            socklen_t len = sizeof(st);
+            if (getsockopt(m_fd, SOL_PACKET, PACKET_STATISTICS,
+                           &st, &len) == 0)
+                m_stats.k_drops += st.tp_drops;
+            return m_stats;
+        }
+
+        [[nodiscard]]
+        int fd() const noexcept { return m_fd; }
+    };
+
+} // namespace petronilho::net
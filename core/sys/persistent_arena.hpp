@@ -7,6 +7,7 @@
 #include <atomic>
 #include <iostream>
 #include <stdexcept>
+#include "core/platform/huge_pages.hpp"
 
 namespace petronilho {
 
@@ -14,30 +15,38 @@ class PersistentArena {
     uint8_t* memory;
     size_t capacity;
     int fd;
+    platform::PageMapping mapping;
     alignas(64) std::atomic<size_t> offset;
 
 public:
-    PersistentArena(const char* filename, size_t size) : offset(0) {
+    // pages = HUGE: hugetlbfs ou THP (huge_pages.hpp); page_size()
+    // diz o que foi obtido
+    PersistentArena(const char* filename, size_t size,
+                    platform::PageHint pages = platform::PageHint::SMALL) : offset(0) {
         // 1. Abrir/Criar arquivo no NVMe (ou disco local)
         fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0666);
         if (fd < 0) throw std::runtime_error("Falha ao abrir arquivo");
 
-        // 2. Definir o tamanho do arquivo fisicamente
-        if (ftruncate(fd, size) != 0) throw std::runtime_error("Falha ao redimensionar arquivo");
+        // 2. Definir o tamanho do arquivo fisicamente (hugetlbfs:
+        //    arredondado a pagina grande)
+        const size_t page = platform::file_page_size(fd);
+        const size_t file_size = (size + page - 1) & ~(page - 1);
+        if (ftruncate(fd, file_size) != 0) throw std::runtime_error("Falha ao redimensionar arquivo");
 
-        // 3. Mapeamento Zero-Copy com Blindagem (MAP_POPULATE evita lag de Page Fault)
-        memory = (uint8_t*)mmap(nullptr, size, PROT_READ | PROT_WRITE, 
-                                MAP_SHARED | MAP_POPULATE, fd, 0);
-
-        if (memory == MAP_FAILED) throw std::runtime_error("mmap falhou");
+        // 3. Mapeamento Zero-Copy com Blindagem (populate evita lag de Page Fault)
+        mapping = platform::map_file(fd, size, PROT_READ | PROT_WRITE, pages, true);
+        if (!mapping.ok()) throw std::runtime_error("mmap falhou");
+        memory   = static_cast<uint8_t*>(mapping.ptr);
         capacity = size;
     }
 
     ~PersistentArena() {
-        munmap(memory, capacity);
+        platform::unmap(mapping);
         close(fd);
     }
 
+    platform::PageSize page_size() const { return mapping.page; }
+
     inline void* allocate(size_t size) {
         size_t aligned_req = (size + 63) & ~static_cast<size_t>(63);
         size_t current = offset.fetch_add(aligned_req, std::memory_order_relaxed);
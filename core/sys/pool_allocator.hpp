@@ -0,0 +1,341 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// pool_allocator.hpp - Pool por Classe de Tamanho sobre a Arena
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// As arenas de core/sys sao monotonicas: estruturas que removem
+// (entradas de HashTable, nos de heap, registros de cluster)
+// vazam ate o proximo reset. SizeClassPool recicla blocos:
+//
+//   allocate<T>(n)     -> Handle<T>, como ScalableArena
+//   deallocate(h, n)   -> bloco volta para reuso (mesmo n)
+//
+// Tres niveis, do mais rapido ao mais lento:
+//   1. cache da thread : lista livre por classe, sem atomicos
+//   2. deposito        : lotes de BATCH blocos por classe, sob
+//                        spinlock; uma operacao a cada BATCH
+//   3. arena           : blocos novos talhados em lote da
+//                        ScalableArena
+//
+// FREE DE OUTRA THREAD: o bloco entra no cache de quem liberou;
+// quando o cache passa de CACHE_MAX, um lote inteiro vai para o
+// deposito e a thread que aloca o busca de uma vez. Produtor e
+// consumidor (recepcao aloca, logica libera) giram os mesmos
+// blocos: a memoria fica limitada ao pico em uso + caches.
+//
+// Classes: 16..256 de 16 em 16, depois 4 por potencia de 2 ate
+// 32KB (erro maximo de 25%). Maior que MAX_BLOCK: null.
+//
+// O pool toma memoria da arena e nunca a devolve: nao chame
+// reset() na arena enquanto o pool estiver em uso. Uma thread
+// que termina deve chamar flush_thread(), senao seu cache
+// (no maximo CACHE_MAX blocos por classe) fica perdido.
+//
+// CACHES POR THREAD: TLS_SLOTS pools por thread. Um quinto pool
+// toma o slot de outro; o cache despejado volta ao deposito do
+// dono, achado num registro global de pools vivos (lista sob
+// spinlock, tocada so no despejo e na construcao/destruicao).
+//
+// ALGORITMO: Listas Livres Segregadas por Tamanho
+// BASE TEORICA: Cormen Cap.10 Sec.10.3 - Implementing Pointers
+//               and Objects (lista livre de objetos)
+//               Cormen Cap.17 - Analise Amortizada
+// Cada classe e uma lista livre como a free list do Cormen 10.3:
+// allocate-object e free-object sao O(1). O deposito e a arena
+// sao tocados uma vez a cada BATCH operacoes: custo amortizado
+// O(1) com um atomico por BATCH.
+//
+// Complexidade: allocate/deallocate O(1) amortizado
+// Thread-safety: N threads alocando e liberando
+// ================================================================
+
+#pragma once
+#include "arena.hpp"
+#include "handle.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace petronilho::sys {
+
+    struct PoolConfig {
+        static constexpr uint32_t CLASSES    = 16 + 4 * 7;  // 16..256, 320..32K
+        static constexpr size_t   MAX_BLOCK  = 32 * 1024;
+        static constexpr uint32_t BATCH      = 32;          // blocos por lote
+        static constexpr uint32_t CACHE_MAX  = 2 * BATCH;   // por classe, por thread
+        static constexpr size_t   CARVE_MAX  = 64 * 1024;   // bytes por talho da arena
+        static constexpr uint32_t TLS_SLOTS  = 4;           // pools por thread
+
+        // Tamanho do bloco da classe c
+        static constexpr size_t class_size(uint32_t c) noexcept {
+            if (c < 16) return size_t(c + 1) * 16;
+            const uint32_t k   = c - 16;          // 0.. : 4 passos por oitava
+            const size_t   oct = size_t(256) << (k / 4);
+            return oct + (oct / 4) * (k % 4 + 1);
+        }
+
+        // Menor classe que cabe bytes com o alinhamento pedido
+        // (ate 64: os talhos saem alinhados a 64)
+        static constexpr uint32_t class_of(size_t bytes, size_t align) noexcept {
+            if (align > 64) return CLASSES;
+            uint32_t c = bytes <= 256 ? (bytes ? uint32_t((bytes - 1) / 16) : 0) : 16;
+            while (c < CLASSES && (class_size(c) < bytes || class_size(c) % align))
+                ++c;
+            return c;   // == CLASSES: nao cabe
+        }
+    };
+
+    static_assert(PoolConfig::class_size(PoolConfig::CLASSES - 1) == PoolConfig::MAX_BLOCK,
+                  "ultima classe deve ser MAX_BLOCK");
+
+    class SizeClassPool {
+    private:
+        // Bloco livre: o primeiro word liga a lista; no primeiro
+        // bloco de um lote do deposito, o segundo liga o proximo lote
+        struct FreeBlock {
+            FreeBlock* next;
+            FreeBlock* next_batch;
+        };
+
+        struct FreeList {
+            FreeBlock* head  = nullptr;
+            uint32_t   count = 0;
+        };
+
+        struct ThreadCache {
+            uint64_t pool = 0;   // m_id do dono; 0 = livre
+            FreeList lists[PoolConfig::CLASSES];
+        };
+
+        struct alignas(64) Depot {
+            std::atomic_flag      lock = ATOMIC_FLAG_INIT;
+            FreeBlock*            batches = nullptr;
+            std::atomic<uint32_t> count{0};   // lotes; lido sem lock
+        };
+
+        // Pools vivos: o despejo de um cache acha o dono pelo id
+        struct Registry {
+            std::atomic_flag lock = ATOMIC_FLAG_INIT;
+            SizeClassPool*   head = nullptr;
+        };
+
+        ScalableArena&                    m_arena;
+        uint64_t                          m_id;
+        SizeClassPool*                    m_next_live;  // lista do Registry
+        std::atomic<uint8_t*>             m_base;      // base dos Handle (da arena)
+        alignas(64) std::atomic<uint64_t> m_carved;    // bytes tomados da arena
+        Depot                             m_depot[PoolConfig::CLASSES];
+
+        static thread_local ThreadCache t_caches[PoolConfig::TLS_SLOTS];
+        static thread_local uint32_t    t_victim;
+
+        static uint64_t next_id() noexcept {
+            static std::atomic<uint64_t> s_ids{1};
+            return s_ids.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static Registry& registry() noexcept {
+            static Registry r;
+            return r;
+        }
+
+        static void lock(std::atomic_flag& f) noexcept {
+            while (f.test_and_set(std::memory_order_acquire)) _mm_pause();
+        }
+
+        static void unlock(std::atomic_flag& f) noexcept { f.clear(std::memory_order_release); }
+
+        // Cache despejado volta ao dono, se ele ainda existe. O lock
+        // do registro impede o dono de ser destruido no meio
+        static void return_evicted(ThreadCache& c) noexcept {
+            Registry& r = registry();
+            lock(r.lock);
+            for (SizeClassPool* p = r.head; p; p = p->m_next_live)
+                if (p->m_id == c.pool) { p->give_back(c); break; }
+            unlock(r.lock);
+        }
+
+        // Cache desta thread para este pool. Sem slot, toma um em
+        // rodizio e devolve o cache do pool anterior ao deposito dele
+        PETRONILHO_FORCE_INLINE ThreadCache& local_cache() const noexcept {
+            for (uint32_t i = 0; i < PoolConfig::TLS_SLOTS; ++i)
+                if (t_caches[i].pool == m_id) return t_caches[i];
+            ThreadCache& c = t_caches[t_victim++ % PoolConfig::TLS_SLOTS];
+            if (c.pool) return_evicted(c);
+            c = ThreadCache{};
+            c.pool = m_id;
+            return c;
+        }
+
+        void lock(Depot& d) noexcept { lock(d.lock); }
+
+        void unlock(Depot& d) noexcept { unlock(d.lock); }
+
+        // Primeiros BATCH blocos da lista viram um lote no deposito
+        void push_batch(uint32_t c, FreeList& l) noexcept {
+            FreeBlock* first = l.head;
+            FreeBlock* last  = first;
+            for (uint32_t i = 1; i < PoolConfig::BATCH; ++i) last = last->next;
+            l.head   = last->next;
+            l.count -= PoolConfig::BATCH;
+            last->next = nullptr;
+
+            Depot& d = m_depot[c];
+            lock(d);
+            first->next_batch = d.batches;
+            d.batches = first;
+            d.count.fetch_add(1, std::memory_order_relaxed);
+            unlock(d);
+        }
+
+        // Lista vazia: um lote do deposito ou blocos novos da arena
+        bool refill(uint32_t c, FreeList& l) noexcept {
+            Depot& d = m_depot[c];
+            FreeBlock* batch = nullptr;
+            if (d.count.load(std::memory_order_relaxed)) {
+                lock(d);
+                batch = d.batches;
+                if (batch) {
+                    d.batches = batch->next_batch;
+                    d.count.fetch_sub(1, std::memory_order_relaxed);
+                }
+                unlock(d);
+            }
+            if (batch) {
+                uint32_t n = 0;
+                for (FreeBlock* b = batch; b; b = b->next) ++n;
+                l.head  = batch;
+                l.count = n;
+                return true;
+            }
+            return carve(c, l);
+        }
+
+        bool carve(uint32_t c, FreeList& l) noexcept {
+            const size_t size = PoolConfig::class_size(c);
+            size_t n = PoolConfig::CARVE_MAX / size;
+            if (n > PoolConfig::BATCH) n = PoolConfig::BATCH;
+            if (n == 0) n = 1;
+
+            // A arena nao alinha o inicio: 63 bytes de folga e o
+            // talho comeca na proxima linha de 64
+            auto h = m_arena.allocate<uint8_t>(n * size + 63, ArenaTag::POOL);
+            if (h.is_null()) return false;
+            m_base.store(h.m_pool_base, std::memory_order_relaxed);
+            m_carved.fetch_add(n * size + 63, std::memory_order_relaxed);
+
+            uint8_t* p = reinterpret_cast<uint8_t*>(
+                (reinterpret_cast<uintptr_t>(h.get_ptr()) + 63) & ~uintptr_t(63));
+            for (size_t i = 0; i < n; ++i) {
+                FreeBlock* b = reinterpret_cast<FreeBlock*>(p + i * size);
+                b->next = l.head;
+                l.head  = b;
+            }
+            l.count += static_cast<uint32_t>(n);
+            return true;
+        }
+
+        // Todas as listas do cache vao para o deposito, em lotes
+        void give_back(ThreadCache& tc) noexcept {
+            for (uint32_t c = 0; c < PoolConfig::CLASSES; ++c) {
+                FreeList& l = tc.lists[c];
+                while (l.count >= PoolConfig::BATCH) push_batch(c, l);
+                if (!l.count) continue;
+                // Resto menor que um lote tambem vira lote
+                Depot& d = m_depot[c];
+                lock(d);
+                l.head->next_batch = d.batches;
+                d.batches = l.head;
+                d.count.fetch_add(1, std::memory_order_relaxed);
+                unlock(d);
+                l = FreeList{};
+            }
+        }
+
+    public:
+        explicit SizeClassPool(ScalableArena& arena) noexcept
+            : m_arena(arena), m_id(next_id()), m_next_live(nullptr)
+            , m_base(nullptr), m_carved(0)
+        {
+            Registry& r = registry();
+            lock(r.lock);
+            m_next_live = r.head;
+            r.head = this;
+            unlock(r.lock);
+        }
+
+        // Caches de outras threads com o id deste pool sao
+        // descartados no despejo (os blocos sao da arena)
+        ~SizeClassPool() {
+            Registry& r = registry();
+            lock(r.lock);
+            for (SizeClassPool** p = &r.head; *p; p = &(*p)->m_next_live)
+                if (*p == this) { *p = m_next_live; break; }
+            unlock(r.lock);
+        }
+
+        SizeClassPool(const SizeClassPool&)            = delete;
+        SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+        // ============================================================
+        // allocate<T> - bloco da menor classe que cabe count x T
+        // Null: maior que MAX_BLOCK ou arena cheia
+        // ============================================================
+        template<typename T>
+        [[nodiscard]]
+        Handle<T> allocate(size_t count = 1) noexcept {
+            const uint32_t c = PoolConfig::class_of(sizeof(T) * count, alignof(T));
+            if (c >= PoolConfig::CLASSES) return Handle<T>::null();
+
+            FreeList& l = local_cache().lists[c];
+            if (!l.head && !refill(c, l)) return Handle<T>::null();
+
+            FreeBlock* b = l.head;
+            l.head = b->next;
+            --l.count;
+            uint8_t* base = m_base.load(std::memory_order_relaxed);
+            return Handle<T>{
+                static_cast<uint32_t>(reinterpret_cast<uint8_t*>(b) - base), base };
+        }
+
+        // ============================================================
+        // deallocate - devolve o bloco (count igual ao do allocate)
+        // Qualquer thread pode liberar
+        // ============================================================
+        template<typename T>
+        void deallocate(Handle<T> h, size_t count = 1) noexcept {
+            if (h.is_null()) return;
+            const uint32_t c = PoolConfig::class_of(sizeof(T) * count, alignof(T));
+            if (c >= PoolConfig::CLASSES) return;
+
+            FreeList& l = local_cache().lists[c];
+            FreeBlock* b = reinterpret_cast<FreeBlock*>(h.get_ptr());
+            b->next = l.head;
+            l.head  = b;
+            if (++l.count >= PoolConfig::CACHE_MAX) push_batch(c, l);
+        }
+
+        // Devolve o cache da thread ao deposito (fim da thread)
+        void flush_thread() noexcept { give_back(local_cache()); }
+
+        // Bytes tomados da arena (teto da memoria do pool)
+        [[nodiscard]]
+        uint64_t carved() const noexcept { return m_carved.load(std::memory_order_relaxed); }
+
+        // Lotes parados no deposito da classe de bytes
+        [[nodiscard]]
+        uint32_t depot_batches(size_t bytes) const noexcept {
+            const uint32_t c = PoolConfig::class_of(bytes, 1);
+            return c < PoolConfig::CLASSES
+                ? m_depot[c].count.load(std::memory_order_relaxed) : 0;
+        }
+    };
+
+    inline thread_local SizeClassPool::ThreadCache
+        SizeClassPool::t_caches[PoolConfig::TLS_SLOTS]{};
+    inline thread_local uint32_t SizeClassPool::t_victim = 0;
+
+} // namespace petronilho::sys
@@ -0,0 +1,108 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// probe_header.hpp - Cabecalho de Sonda no Payload de Teste
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Define os primeiros 32 bytes de todo datagrama gerado pelo
+// net_stress_gen. O ingestor le o cabecalho no lugar (sem copia)
+// e obtem:
+//
+//   stream + seq : lacunas na sequencia de cada fluxo = perda
+//   send_tsc     : TSC lido logo antes do sendmmsg (envio real)
+//   intended_tsc : TSC em que o pacote DEVIA sair pelo agendador
+//                  (base para corrigir coordinated omission)
+//
+// Gerador e ingestor na mesma maquina (loopback) compartilham o
+// TSC invariante: latencia = tsc_agora - send_tsc, em ciclos.
+// tsc_per_ns() converte para nanossegundos.
+//
+// ALGORITMO: Numeracao Sequencial por Fluxo
+// BASE TEORICA: Cormen Cap.11 Sec.11.1 - Direct-Address Tables
+// O receptor guarda a proxima seq esperada indexada pelo stream:
+// verificacao de perda O(1) por pacote.
+//
+// Complexidade: stamp O(1), check O(1)
+// ================================================================
+
+#pragma once
+#include "telemetry.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace petronilho::net {
+
+    static constexpr uint32_t PROBE_MAGIC = 0x50524F42;  // "PROB"
+
+    struct ProbeHeader {
+        uint32_t magic;
+        uint16_t stream;        // thread geradora
+        uint16_t flags;
+        uint64_t seq;           // sequencia dentro do stream
+        uint64_t send_tsc;      // TSC no envio real
+        uint64_t intended_tsc;  // TSC agendado pelo pacing
+    };
+
+    static_assert(sizeof(ProbeHeader) == 32, "ProbeHeader deve ter 32 bytes");
+
+    // Le o cabecalho no lugar; false se o datagrama nao e sonda
+    [[nodiscard]]
+    inline bool read_probe(const void* data, uint32_t len,
+                           ProbeHeader& out) noexcept {
+        if (len < sizeof(ProbeHeader)) return false;
+        std::memcpy(&out, data, sizeof(ProbeHeader));
+        return out.magic == PROBE_MAGIC;
+    }
+
+    // ============================================================
+    // SequenceTracker - perda por lacuna de sequencia
+    // MaxStreams fluxos independentes (um por thread geradora).
+    // Reordenacao conta como lacuna + tardio.
+    // ============================================================
+    template<uint32_t MaxStreams>
+    class SequenceTracker {
+    private:
+        uint64_t m_next[MaxStreams];
+        uint64_t m_received;
+        uint64_t m_lost;
+        uint64_t m_late;  // seq menor que a esperada (reordenado/dup)
+
+    public:
+        SequenceTracker() noexcept { reset(); }
+
+        void reset() noexcept {
+            std::memset(m_next, 0, sizeof(m_next));
+            m_received = 0;
+            m_lost     = 0;
+            m_late     = 0;
+        }
+
+        // Cormen Sec.11.1: acesso direto pelo stream
+        void observe(uint16_t stream, uint64_t seq) noexcept {
+            if (stream >= MaxStreams) return;
+            ++m_received;
+            uint64_t& next = m_next[stream];
+            if (seq == next)     { ++next; return; }
+            if (seq > next)      { m_lost += seq - next; next = seq + 1; return; }
+            ++m_late;
+        }
+
+        [[nodiscard]]
+        uint64_t received() const noexcept { return m_received; }
+
+        [[nodiscard]]
+        uint64_t lost() const noexcept { return m_lost; }
+
+        [[nodiscard]]
+        uint64_t late() const noexcept { return m_late; }
+
+        // Perda / (recebidos + perdidos)
+        [[nodiscard]]
+        double loss_ratio() const noexcept {
+            const uint64_t total = m_received + m_lost;
+            return total ? static_cast<double>(m_lost) / total : 0.0;
+        }
+    };
+
+} // namespace petronilho::net
@@ -2,94 +2,786 @@
 #define RING_BUFFER_HPP
 
 #include <cstdint>
+#include <cstddef>
 #include <cstring>
 #include <atomic>
 #include <string>
 #include <stdexcept>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include "core/platform/crc32c.hpp"
+#include "core/platform/huge_pages.hpp"
+#include "core/platform/numa.hpp"
 
 namespace petronilho {
 
+// Registro = 1..N slots contiguos de 64 bytes. O primeiro slot
+// leva o cabecalho e os primeiros 40 bytes; o payload continua
+// pelos slots seguintes sem cabecalho. span = slots do registro.
+// span e 16 bits: um registro tem no maximo RING_MAX_SPAN slots.
 struct alignas(64) RingSlot {
     uint64_t timestamp_ns;
     uint32_t latency_ns;
     uint32_t packet_id;
     uint32_t payload_len;
-    uint8_t  _pad[4];
+    uint16_t span;
+    uint16_t flags;
     uint8_t  payload[40];
 };
 
 static_assert(sizeof(RingSlot) == 64, "RingSlot deve ter 64 bytes");
 
+// Selo dos aneis com recuperacao (RingOpen::RECOVER), nos 8
+// primeiros bytes de payload; o payload comeca logo depois.
+// seq = indice do registro (32 bits baixos): distingue o registro
+// desta volta de um antigo no mesmo slot. crc = CRC32C do cabecalho
+// (ate seq) e do payload. Sem recuperacao nao ha selo e o slot
+// guarda os 40 bytes inteiros.
+struct RingSeal {
+    uint32_t seq;
+    uint32_t crc;
+};
+
+static constexpr uint32_t RING_INLINE_BYTES        = sizeof(RingSlot::payload);
+static constexpr uint32_t RING_SEAL_BYTES          = sizeof(RingSeal);
+static constexpr uint32_t RING_SEALED_INLINE_BYTES = RING_INLINE_BYTES - RING_SEAL_BYTES;
+static constexpr uint16_t RING_PAD          = 1;  // enchimento ate o fim do anel
+static constexpr uint16_t RING_RESERVED     = 2;  // reservado, ainda sem commit
+static constexpr uint32_t RING_MAX_SPAN     = 0xFFFF;  // slots por registro
+
+// Entrada de write_batch (payload fora do anel)
+struct RingRecord {
+    uint64_t    timestamp_ns;
+    uint32_t    latency_ns;
+    uint32_t    packet_id;
+    const void* data;
+    uint32_t    len;
+};
+
+// ================================================================
+// Layout do arquivo: [RingHeader, 4KB][slots, capacity x 64B]
+// O cabecalho leva os indices: outro processo que mapeie o arquivo
+// ve o mesmo anel (RingAttach). Cada indice tem linha propria.
+// ================================================================
+static constexpr uint32_t RING_MAGIC        = 0x474E4952;  // "RING"
+static constexpr uint32_t RING_VERSION      = 3;  // 3: selo so com RECOVER
+static constexpr size_t   RING_HEADER_BYTES = 4096;
+static constexpr uint32_t RING_HDR_CHECKSUM  = 1;  // slots com crc (recuperavel)
+static constexpr uint32_t RING_HDR_OVERWRITE = 2;  // produtor move read_idx
+
+struct alignas(64) RingHeader {
+    uint32_t magic;        // gravado por ultimo pelo dono
+    uint32_t version;
+    uint32_t mode;         // RingMode
+    uint32_t flags;        // RING_HDR_*
+    uint64_t capacity;     // slots
+    uint64_t durable_write; // fronteira de registro ja gravada; a
+                            // recuperacao varre a partir dela
+    alignas(64) std::atomic<size_t> write_idx;
+    alignas(64) std::atomic<size_t> read_idx;
+};
+
+static_assert(sizeof(RingHeader) <= RING_HEADER_BYTES, "RingHeader cabe na pagina");
+static_assert(std::atomic<size_t>::is_always_lock_free,
+              "indices compartilhados entre processos exigem atomic sem lock");
+
+// Marca do construtor que anexa um consumidor a um anel existente
+struct RingAttach {};
+inline constexpr RingAttach RING_ATTACH{};
+
+// FIXED: 1 slot por registro, payload truncado em inline_bytes():
+//        40 (RING_INLINE_BYTES), 32 com RECOVER (selo no slot).
+// VARIABLE: payload inteiro, registro ocupa quantos slots precisar.
+enum class RingMode : uint8_t { FIXED, VARIABLE };
+
+// CREATE: arquivo novo (O_TRUNC), sem checksum.
+// RECOVER: reabre o arquivo de uma execucao anterior e recupera o
+// backlog nao lido; sem arquivo compativel, cria um novo. Os slots
+// levam CRC32C (custo O(len) por registro gravado).
+enum class RingOpen : uint8_t { CREATE, RECOVER };
+
+// REJECT: anel cheio recusa o registro novo; so o consumidor move
+// read_idx, que ele avanca com um store simples.
+// OVERWRITE: write_overwrite() descarta os mais antigos movendo
+// read_idx; o consumidor entao confirma cada leitura com CAS.
+// Gravado no cabecalho: quem anexa segue o protocolo do dono.
+enum class RingOverflow : uint8_t { REJECT, OVERWRITE };
+
+// Resultado da abertura em RECOVER
+struct RingRecovery {
+    bool     reopened      = false;  // havia anel compativel no arquivo
+    uint64_t records       = 0;      // registros nao lidos recuperados
+    uint64_t slots_dropped = 0;      // slots corrompidos viraram PAD
+};
+
 class RingBuffer {
 private:
+    // Campos frios: escritos so no construtor, lidos pelos dois lados.
+    // Os indices ficam em m_hdr (no mapeamento, um por linha).
+    RingHeader*          m_hdr;
     RingSlot*            m_slots;
     size_t               m_capacity;
     size_t               m_mask;
-    std::atomic<size_t>  m_write_idx;
-    std::atomic<size_t>  m_read_idx;
     int                  m_fd;
+    RingMode             m_mode;
+    bool                 m_consumer;   // anexado: slots somente leitura
+    bool                 m_checksum;   // RECOVER: sela slots com crc
+    bool                 m_overwrite;  // RingOverflow::OVERWRITE
+    RingRecovery         m_recovery;
+    platform::PageMapping m_map;
+
+    // Estado local do produtor. m_read_cache = ultimo read_idx visto;
+    // so e relido quando o espaco calculado com ele nao basta.
+    // m_reserved = fim das reservas (>= write_idx), m_outstanding =
+    // reservas sem commit.
+    alignas(64) size_t   m_read_cache;
+    size_t               m_reserved;
+    uint32_t             m_outstanding;
+
+    // Estado local do consumidor. m_write_cache = ultimo write_idx
+    // visto; so e relido quando o consumidor o alcanca. m_peek_* =
+    // registro devolvido por peek().
+    alignas(64) size_t   m_write_cache;
+    size_t               m_peek_idx;
+    size_t               m_peek_span;
+
+    size_t map_bytes() const noexcept {
+        return RING_HEADER_BYTES + m_capacity * sizeof(RingSlot);
+    }
+
+    // Inicio do payload no slot: depois do selo, se houver
+    size_t payload_offset() const noexcept {
+        return offsetof(RingSlot, payload) + (m_checksum ? RING_SEAL_BYTES : 0);
+    }
+
+    // Bytes de payload num registro de span slots
+    size_t room(size_t span) const noexcept {
+        return span * sizeof(RingSlot) - payload_offset();
+    }
+
+    uint32_t span_of(uint32_t len) const noexcept {
+        const uint32_t inline_len = inline_bytes();
+        return len <= inline_len
+            ? 1u
+            : 1u + (len - inline_len + sizeof(RingSlot) - 1) / sizeof(RingSlot);
+    }
+
+    uint8_t* payload_at(size_t idx) noexcept {
+        return reinterpret_cast<uint8_t*>(m_slots + (idx & m_mask)) + payload_offset();
+    }
+
+    const uint8_t* payload_at(size_t idx) const noexcept {
+        return reinterpret_cast<const uint8_t*>(m_slots + (idx & m_mask)) + payload_offset();
+    }
+
+    static RingSeal seal_of(const RingSlot& s) noexcept {
+        RingSeal x;
+        std::memcpy(&x, s.payload, sizeof(x));
+        return x;
+    }
+
+    uint32_t record_crc(const RingSlot& s, size_t idx) const noexcept {
+        const uint32_t c = platform::crc32c(&s, offsetof(RingSlot, payload) + offsetof(RingSeal, crc));
+        return platform::crc32c(payload_at(idx), s.payload_len, c);
+    }
+
+    // Fecha o registro em idx (flags ja finais): em RECOVER grava seq
+    // e crc no selo. Sem recuperacao nao ha selo
+    void seal(size_t idx) noexcept {
+        if (!m_checksum) return;
+        RingSlot& s = m_slots[idx & m_mask];
+        RingSeal  x{ static_cast<uint32_t>(idx), 0 };
+        std::memcpy(s.payload, &x, sizeof(x));
+        x.crc = record_crc(s, idx);
+        std::memcpy(s.payload, &x, sizeof(x));
+    }
+
+    // Copia de um slot selado: payload movido para out.payload, como
+    // num anel sem selo (quem le nao ve seq/crc)
+    void unseal(RingSlot& out) const noexcept {
+        if (m_checksum)
+            std::memmove(out.payload, out.payload + RING_SEAL_BYTES, RING_SEALED_INLINE_BYTES);
+    }
+
+    void publish(size_t w) noexcept {
+        m_hdr->write_idx.store(w, std::memory_order_release);
+        // Cursor duravel a cada quarto de volta: a recuperacao varre
+        // no maximo um quarto do anel alem dele
+        if (m_checksum && w - m_hdr->durable_write >= (m_capacity >> 2))
+            m_hdr->durable_write = w;
+    }
+
+    // Maior span aceito: metade do anel, ate RING_MAX_SPAN (16 bits
+    // do slot). O PAD so existe quando o registro cruza o fim, entao
+    // pad < span e pad + span < capacity: um registro aceito sempre
+    // cabe num anel vazio, de qualquer posicao.
+    size_t max_span() const noexcept {
+        const size_t half = m_capacity > 1 ? m_capacity / 2 : 1;
+        return half < RING_MAX_SPAN ? half : RING_MAX_SPAN;
+    }
+
+    // Reserva span slots contiguos apos a ultima reserva. Se o registro nao
+    // cabe antes do fim do anel, grava um registro RING_PAD ate o fim
+    // e comeca no slot 0. overwrite: descarta registros antigos (CAS
+    // em read_idx) ate caber. Retorna false se nao ha espaco.
+    bool place(size_t& w, uint32_t span, bool overwrite, bool& evicted) noexcept {
+        if (m_consumer || span > max_span()) return false;
+        w = m_reserved;
+        const size_t idx  = w & m_mask;
+        const size_t pad  = (idx + span > m_capacity) ? m_capacity - idx : 0;
+        const size_t need = pad + span;
+        // Nunca com span <= max_span(); se passasse, o descarte
+        // levaria read_idx alem de write_idx
+        if (need > m_capacity) return false;
+
+        // m_read_cache so fica atras do real: se ja ha espaco com ele,
+        // ha espaco de verdade e a linha do consumidor nao e tocada
+        size_t r = m_read_cache;
+        if (w + need - r > m_capacity) {
+            r = m_hdr->read_idx.load(std::memory_order_acquire);
+            while (w + need - r > m_capacity) {
+                if (!overwrite) { m_read_cache = r; return false; }
+                const uint16_t s = m_slots[r & m_mask].span;
+                if (m_hdr->read_idx.compare_exchange_strong(r, r + (s ? s : 1),
+                        std::memory_order_acq_rel, std::memory_order_acquire))
+                    evicted = true;
+                r = m_hdr->read_idx.load(std::memory_order_acquire);
+            }
+            m_read_cache = r;
+        }
+
+        if (pad) {
+            RingSlot& p   = m_slots[idx];
+            p.payload_len = 0;
+            p.span        = static_cast<uint16_t>(pad);
+            p.flags       = RING_PAD;
+            seal(w);
+            w += pad;
+        }
+        return true;
+    }
+
+    // Grava um registro apos a ultima reserva e avanca m_reserved,
+    // sem publicar. store() e write_batch() fazem o store release.
+    bool stage(uint64_t ts_ns, uint32_t lat_ns, uint32_t pkt_id,
+               const void* data, uint32_t len, bool overwrite, bool& evicted) noexcept
+    {
+        const uint32_t stored = (m_mode == RingMode::FIXED && len > inline_bytes())
+                              ? inline_bytes() : len;
+        const uint32_t span = span_of(stored);
+        size_t w;
+        if (!place(w, span, overwrite, evicted)) return false;
+
+        RingSlot& slot    = m_slots[w & m_mask];
+        slot.timestamp_ns = ts_ns;
+        slot.latency_ns   = lat_ns;
+        slot.packet_id    = pkt_id;
+        slot.payload_len  = stored;
+        slot.span         = static_cast<uint16_t>(span);
+        slot.flags        = 0;
+        // Slots contiguos: uma unica copia, mesmo com varios slots
+        if (data && stored > 0)
+            std::memcpy(payload_at(w), data, stored);
+        seal(w);
+        m_reserved = w + span;
+        return true;
+    }
+
+    bool store(uint64_t ts_ns, uint32_t lat_ns, uint32_t pkt_id,
+               const void* data, uint32_t len, bool overwrite, bool& evicted) noexcept
+    {
+        // Reservas pendentes publicariam fora de ordem
+        if (m_outstanding || !stage(ts_ns, lat_ns, pkt_id, data, len, overwrite, evicted))
+            return false;
+        publish(m_reserved);
+        return true;
+    }
+
+    // Ultimo write_idx publicado visto pelo consumidor. So le a
+    // linha do produtor quando r alcancou a copia local (ou a passou:
+    // o overwrite do produtor avanca read_idx).
+    size_t visible_end(size_t r) noexcept {
+        if (r < m_write_cache) return m_write_cache;
+        m_write_cache = m_hdr->write_idx.load(std::memory_order_acquire);
+        return m_write_cache;
+    }
+
+    // Primeira reserva sem commit, a partir de write_idx (pula PAD)
+    size_t oldest_reserved() const noexcept {
+        size_t w = m_hdr->write_idx.load(std::memory_order_relaxed);
+        while (m_slots[w & m_mask].flags & RING_PAD)
+            w += m_slots[w & m_mask].span;
+        return w;
+    }
+
+    // Consumidor avanca read_idx de r para next. Sem overwrite ele e
+    // o unico escritor: store release. Com overwrite o produtor
+    // tambem o move; o CAS so confirma se nada foi descartado desde
+    // a leitura (senao r recebe o read_idx atual e retorna false).
+    bool advance(size_t& r, size_t next) noexcept {
+        if (!m_overwrite) {
+            m_hdr->read_idx.store(next, std::memory_order_release);
+            return true;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_hdr->read_idx.compare_exchange_strong(r, next,
+            std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+    // Le o proximo registro (pula RING_PAD). O produtor pode mover
+    // read_idx (overwrite): a copia so vale se o CAS confirmar.
+    // Retorna bytes de payload copiados para buf, ou -1 se vazio.
+    int64_t fetch(RingSlot& out, void* buf, uint32_t cap) noexcept {
+        size_t r = m_hdr->read_idx.load(std::memory_order_acquire);
+        for (;;) {
+            if (r == visible_end(r)) return -1;
+            out = m_slots[r & m_mask];
+            size_t step = out.span ? out.span : 1;
+            if (step > m_capacity - (r & m_mask)) step = m_capacity - (r & m_mask);
+
+            uint32_t copied = 0;
+            if (!(out.flags & RING_PAD) && buf) {
+                const size_t bytes = room(step);
+                copied = out.payload_len < cap ? out.payload_len : cap;
+                if (copied > bytes) copied = static_cast<uint32_t>(bytes);
+                std::memcpy(buf, payload_at(r), copied);
+            }
+            if (!advance(r, r + step)) continue;
+            if (out.flags & RING_PAD) { r += step; continue; }
+            unseal(out);
+            return copied;
+        }
+    }
+
+    // Cabecalho no arquivo confere com o anel pedido (RECOVER)
+    bool compatible_header() const noexcept {
+        RingHeader hdr;
+        return pread(m_fd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr)
+            && hdr.magic == RING_MAGIC && hdr.version == RING_VERSION
+            && hdr.capacity == m_capacity
+            && hdr.mode == static_cast<uint32_t>(m_mode)
+            && (hdr.flags & RING_HDR_CHECKSUM);
+    }
+
+    // Registro integro comeca em idx: seq desta volta, nao reservado,
+    // nao cruza o fim do anel e o crc confere
+    bool valid_at(size_t idx) const noexcept {
+        const RingSlot& s = m_slots[idx & m_mask];
+        const RingSeal  x = seal_of(s);
+        if (x.seq != static_cast<uint32_t>(idx) || s.span == 0) return false;
+        if (s.flags != 0 && s.flags != RING_PAD) return false;
+        if (s.span > m_capacity - (idx & m_mask)) return false;
+        if (s.payload_len > room(s.span)) return false;
+        return x.crc == record_crc(s, idx);
+    }
+
+    // Transforma [p, q) em registros PAD (o consumidor os pula)
+    void pad_range(size_t p, size_t q) noexcept {
+        while (p < q) {
+            size_t n = m_capacity - (p & m_mask);
+            if (n > q - p)  n = q - p;
+            if (n > RING_MAX_SPAN) n = RING_MAX_SPAN;
+            RingSlot& s   = m_slots[p & m_mask];
+            s.payload_len = 0;
+            s.span        = static_cast<uint16_t>(n);
+            s.flags       = RING_PAD;
+            seal(p);
+            m_recovery.slots_dropped += n;
+            p += n;
+        }
+    }
+
+    // ============================================================
+    // recover - Reconstroi os cursores de um anel reaberto
+    // ALGORITMO: Varredura Linear com Validacao
+    // BASE TEORICA: Cormen Cap.10 Sec.10.2 - Listas Ligadas
+    // Os registros formam uma lista implicita (proximo = idx + span).
+    // 1. Fim real: segue a lista a partir de durable_write enquanto
+    //    seq e crc conferem. Cobre o que foi gravado apos o ultimo
+    //    cursor duravel, inclusive lotes nao publicados. Se a lista
+    //    quebra antes do write_idx do cabecalho, procura o proximo
+    //    registro integro ate ele e continua (o buraco vira PAD no
+    //    passo 2).
+    // 2. Inicio: read_idx do cabecalho, limitado a [fim - capacity,
+    //    fim]. Segue a lista ate o fim; um registro invalido vira PAD
+    //    ate o proximo slot que inicia um registro integro.
+    // Complexidade: O(capacity) no pior caso, uma vez por abertura
+    // ============================================================
+    void recover() noexcept {
+        const size_t start = m_hdr->durable_write;
+        const size_t live  = m_hdr->write_idx.load(std::memory_order_relaxed);
+        const size_t limit = start + m_capacity;
+        size_t end = start;
+        for (;;) {
+            while (end < limit && valid_at(end))
+                end += m_slots[end & m_mask].span;
+            if (end >= live || live > limit) break;
+            size_t q = end + 1;
+            while (q < live && !valid_at(q)) ++q;
+            if (q >= live) break;
+            end = q;
+        }
+
+        const size_t lo = end > m_capacity ? end - m_capacity : 0;
+        size_t r = m_hdr->read_idx.load(std::memory_order_relaxed);
+        if (r > end) r = end;
+        if (r < lo)  r = lo;
+
+        for (size_t p = r; p < end;) {
+            if (valid_at(p) && p + m_slots[p & m_mask].span <= end) {
+                if (!(m_slots[p & m_mask].flags & RING_PAD)) ++m_recovery.records;
+                p += m_slots[p & m_mask].span;
+                continue;
+            }
+            size_t q = p + 1;
+            while (q < end && !valid_at(q)) ++q;
+            pad_range(p, q);
+            p = q;
+        }
+
+        m_recovery.reopened = true;
+        m_hdr->durable_write = end;
+        m_hdr->write_idx.store(end, std::memory_order_relaxed);
+        m_hdr->read_idx.store(r, std::memory_order_release);
+        m_reserved   = end;
+        m_read_cache = r;
+    }
 
 public:
-    RingBuffer(const std::string& filename, size_t capacity)
-        : m_capacity(capacity), m_mask(capacity - 1)
-        , m_write_idx(0), m_read_idx(0), m_fd(-1)
+    // Dono (produtor). CREATE: cria o arquivo (O_TRUNC) e o
+    // cabecalho; um consumidor anexado a um arquivo antigo com o mesmo
+    // nome perde o mapeamento (SIGBUS), reinicie os consumidores junto.
+    // RECOVER: reaproveita o arquivo se capacidade e modo conferem
+    // (recovery() diz o que foi recuperado); senao cria como CREATE.
+    // pages = HUGE: paginas grandes (huge_pages.hpp) e mapeamento
+    // pre-carregado; page_size() diz o que foi obtido.
+    // overflow = OVERWRITE: habilita write_overwrite() (e o CAS do
+    // consumidor); com REJECT ele grava como write().
+    RingBuffer(const std::string& filename, size_t capacity,
+               RingMode mode = RingMode::FIXED,
+               RingOpen open_mode = RingOpen::CREATE,
+               platform::PageHint pages = platform::PageHint::SMALL,
+               RingOverflow overflow = RingOverflow::REJECT)
+        : m_hdr(nullptr), m_slots(nullptr)
+        , m_capacity(capacity), m_mask(capacity - 1)
+        , m_fd(-1), m_mode(mode), m_consumer(false)
+        , m_checksum(open_mode == RingOpen::RECOVER)
+        , m_overwrite(overflow == RingOverflow::OVERWRITE)
+        , m_read_cache(0), m_reserved(0), m_outstanding(0)
+        , m_write_cache(0), m_peek_idx(0), m_peek_span(0)
     {
-        if ((capacity & (capacity - 1)) != 0)
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
             throw std::runtime_error("Capacidade deve ser potencia de 2");
 
-        size_t file_size = capacity * sizeof(RingSlot);
-        m_fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+        const int flags = O_RDWR | O_CREAT | (m_checksum ? 0 : O_TRUNC);
+        m_fd = open(filename.c_str(), flags, 0666);
         if (m_fd < 0) throw std::runtime_error("Erro ao abrir arquivo");
-        if (ftruncate(m_fd, (off_t)file_size) != 0)
+
+        // hugetlbfs: o arquivo cresce ate a pagina grande
+        const size_t file_bytes = (map_bytes() + platform::file_page_size(m_fd) - 1)
+                                & ~(platform::file_page_size(m_fd) - 1);
+        struct stat st;
+        if (fstat(m_fd, &st) != 0) throw std::runtime_error("Erro no fstat");
+        const bool reuse = m_checksum && (size_t)st.st_size == file_bytes
+                        && compatible_header();
+        if (!reuse && (ftruncate(m_fd, 0) != 0 || ftruncate(m_fd, (off_t)file_bytes) != 0))
             throw std::runtime_error("Erro ao dimensionar arquivo");
-        m_slots = (RingSlot*)mmap(NULL, file_size,
-                                   PROT_READ | PROT_WRITE,
-                                   MAP_SHARED, m_fd, 0);
-        if (m_slots == MAP_FAILED)
-            throw std::runtime_error("Erro no mmap");
+        m_map = platform::map_file(m_fd, map_bytes(), PROT_READ | PROT_WRITE, pages,
+                                   pages == platform::PageHint::HUGE);
+        if (!m_map.ok()) throw std::runtime_error("Erro no mmap");
+        void* base = m_map.ptr;
+
+        m_hdr   = static_cast<RingHeader*>(base);
+        m_slots = reinterpret_cast<RingSlot*>(static_cast<uint8_t*>(base) + RING_HEADER_BYTES);
+        if (reuse) {
+            recover();
+            m_hdr->flags = RING_HDR_CHECKSUM | (m_overwrite ? RING_HDR_OVERWRITE : 0);
+            return;
+        }
+
+        m_hdr->version       = RING_VERSION;
+        m_hdr->mode          = static_cast<uint32_t>(mode);
+        m_hdr->flags         = (m_checksum ? RING_HDR_CHECKSUM : 0)
+                             | (m_overwrite ? RING_HDR_OVERWRITE : 0);
+        m_hdr->capacity      = capacity;
+        m_hdr->durable_write = 0;
+        m_hdr->write_idx.store(0, std::memory_order_relaxed);
+        m_hdr->read_idx.store(0, std::memory_order_relaxed);
+        // magic por ultimo: quem anexa so ve cabecalho completo
+        std::atomic_ref<uint32_t>(m_hdr->magic).store(RING_MAGIC, std::memory_order_release);
     }
 
+    // Consumidor em outro processo: mapeia um anel existente (sem
+    // O_TRUNC). Slots somente leitura; so a pagina do cabecalho e
+    // gravavel, para avancar read_idx. Capacidade, modo e overflow
+    // vem do cabecalho. Um consumidor por anel.
+    RingBuffer(const std::string& filename, RingAttach,
+               platform::PageHint pages = platform::PageHint::SMALL)
+        : m_hdr(nullptr), m_slots(nullptr), m_capacity(0), m_mask(0)
+        , m_fd(-1), m_mode(RingMode::FIXED), m_consumer(true), m_checksum(false)
+        , m_overwrite(false)
+        , m_read_cache(0), m_reserved(0), m_outstanding(0)
+        , m_write_cache(0), m_peek_idx(0), m_peek_span(0)
+    {
+        m_fd = open(filename.c_str(), O_RDWR);
+        if (m_fd < 0) throw std::runtime_error("Erro ao abrir arquivo");
+
+        RingHeader hdr;
+        if (pread(m_fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)
+            || hdr.magic != RING_MAGIC)
+            throw std::runtime_error("Arquivo nao e um RingBuffer");
+        if (hdr.version != RING_VERSION)
+            throw std::runtime_error("Versao de RingBuffer incompativel");
+        if (hdr.capacity == 0 || (hdr.capacity & (hdr.capacity - 1)) != 0)
+            throw std::runtime_error("Cabecalho de RingBuffer corrompido");
+
+        m_capacity = hdr.capacity;
+        m_mask     = hdr.capacity - 1;
+        m_mode      = static_cast<RingMode>(hdr.mode);
+        m_checksum  = (hdr.flags & RING_HDR_CHECKSUM) != 0;   // layout do slot
+        m_overwrite = (hdr.flags & RING_HDR_OVERWRITE) != 0;
+
+        struct stat st;
+        if (fstat(m_fd, &st) != 0 || (size_t)st.st_size < map_bytes())
+            throw std::runtime_error("Arquivo de RingBuffer truncado");
+
+        m_map = platform::map_file(m_fd, map_bytes(), PROT_READ, pages,
+                                   pages == platform::PageHint::HUGE);
+        if (!m_map.ok()) throw std::runtime_error("Erro no mmap");
+        void* base = m_map.ptr;
+        m_hdr   = static_cast<RingHeader*>(base);
+        m_slots = reinterpret_cast<RingSlot*>(static_cast<uint8_t*>(base) + RING_HEADER_BYTES);
+        // hugetlbfs: protecao so por pagina grande (cabecalho gravavel
+        // junto com os slots que dividem a pagina)
+        if (mprotect(base, platform::file_page_size(m_fd), PROT_READ | PROT_WRITE) != 0) {
+            platform::unmap(m_map);
+            throw std::runtime_error("Erro no mprotect do cabecalho");
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    RingBuffer(const RingBuffer&)            = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
     ~RingBuffer() {
-        if (m_slots && m_slots != MAP_FAILED)
-            munmap(m_slots, m_capacity * sizeof(RingSlot));
+        platform::unmap(m_map);
         if (m_fd >= 0) close(m_fd);
     }
 
+    // FIXED: trunca em inline_bytes(). VARIABLE: payload inteiro.
     bool write(uint64_t ts_ns, uint32_t lat_ns,
                uint32_t pkt_id, const void* data, uint32_t len) noexcept
     {
-        size_t w = m_write_idx.load(std::memory_order_relaxed);
-        size_t r = m_read_idx.load(std::memory_order_acquire);
-        if ((w - r) >= m_capacity) return false;
-        RingSlot& slot    = m_slots[w & m_mask];
+        bool evicted = false;
+        return store(ts_ns, lat_ns, pkt_id, data, len, false, evicted);
+    }
+
+    // Cheio: descarta os registros mais antigos (CAS em read_idx)
+    // ate caber. Retorna true se houve descarte. Anel sem
+    // RingOverflow::OVERWRITE: igual a write(), nunca descarta.
+    bool write_overwrite(uint64_t ts_ns, uint32_t lat_ns,
+                         uint32_t pkt_id, const void* data, uint32_t len) noexcept
+    {
+        bool evicted = false;
+        (void)store(ts_ns, lat_ns, pkt_id, data, len, m_overwrite, evicted);
+        return evicted;
+    }
+
+    // write_batch - Grava ate n registros e publica todos com um
+    // unico store release em write_idx: o consumidor ve a linha do
+    // produtor mudar uma vez por lote. Para no primeiro que nao cabe
+    // e retorna quantos foram gravados (prefixo de recs).
+    uint32_t write_batch(const RingRecord* recs, uint32_t n) noexcept {
+        if (m_outstanding) return 0;
+        bool evicted = false;
+        uint32_t i = 0;
+        for (; i < n; ++i) {
+            const RingRecord& rec = recs[i];
+            if (!stage(rec.timestamp_ns, rec.latency_ns, rec.packet_id,
+                       rec.data, rec.len, false, evicted))
+                break;
+        }
+        if (i) publish(m_reserved);
+        return i;
+    }
+
+    // Cabecalho + primeiros inline_bytes() bytes do proximo registro
+    // (em out.payload, com ou sem selo)
+    bool read(RingSlot& out) noexcept {
+        return fetch(out, nullptr, 0) >= 0;
+    }
+
+    // Registro inteiro: cabecalho em hdr (payload_len = tamanho
+    // original) e ate cap bytes de payload em buf. Retorna os bytes
+    // copiados, ou -1 se o anel esta vazio.
+    int64_t read_record(RingSlot& hdr, void* buf, uint32_t cap) noexcept {
+        return fetch(hdr, buf, cap);
+    }
+
+    // read_batch - Copia os cabecalhos (+inline_bytes()) de ate max
+    // registros e libera todos com um unico avanco de read_idx. Com
+    // overwrite o avanco e um CAS, que valida o lote contra
+    // write_overwrite: se falhar, o lote e relido do novo inicio.
+    // Lote so de PAD (fim do anel) e liberado e a leitura segue do
+    // slot 0: 0 so quando o anel esta vazio.
+    // Retorna quantos registros em out.
+    uint32_t read_batch(RingSlot* out, uint32_t max) noexcept {
+        size_t r = m_hdr->read_idx.load(std::memory_order_acquire);
+        for (;;) {
+            const size_t w = visible_end(r);
+            size_t   p = r;
+            uint32_t n = 0;
+            while (p < w && n < max) {
+                const RingSlot& slot = m_slots[p & m_mask];
+                size_t step = slot.span ? slot.span : 1;
+                if (step > m_capacity - (p & m_mask)) step = m_capacity - (p & m_mask);
+                if (!(slot.flags & RING_PAD)) unseal(out[n++] = slot);
+                p += step;
+            }
+            if (p == r) return 0;
+            if (!advance(r, p)) continue;
+            if (n) return n;
+            r = p;
+        }
+    }
+
+    // reserve - Ponteiro gravavel para ate max_len bytes no anel
+    // (PRODUTOR). recv/recvmmsg escrevem direto no mmap; commit()
+    // publica. Varias reservas podem estar pendentes: commit() fecha
+    // sempre a mais antiga, na ordem do reserve. nullptr se nao ha
+    // espaco ou max_len > max_record().
+    uint8_t* reserve(uint32_t max_len) noexcept {
+        if (max_len > max_record()) return nullptr;
+        const uint32_t span = span_of(max_len);
+        bool evicted = false;
+        size_t w;
+        if (!place(w, span, false, evicted)) return nullptr;
+
+        RingSlot& slot   = m_slots[w & m_mask];
+        slot.payload_len = 0;
+        slot.span        = static_cast<uint16_t>(span);
+        slot.flags       = RING_RESERVED;
+        m_reserved = w + span;
+        ++m_outstanding;
+        return payload_at(w);
+    }
+
+    // commit - Publica a reserva mais antiga com len bytes reais.
+    // Se e a unica pendente, devolve os slots que sobraram.
+    bool commit(uint32_t len, uint64_t ts_ns, uint32_t lat_ns,
+                uint32_t pkt_id = 0) noexcept
+    {
+        if (m_outstanding == 0) return false;
+        const size_t w  = oldest_reserved();
+        RingSlot&  slot = m_slots[w & m_mask];
+        const size_t bytes = room(slot.span);
+        if (len > bytes) len = static_cast<uint32_t>(bytes);
+
+        if (m_outstanding == 1) {
+            slot.span  = static_cast<uint16_t>(span_of(len));
+            m_reserved = w + slot.span;
+        }
         slot.timestamp_ns = ts_ns;
         slot.latency_ns   = lat_ns;
         slot.packet_id    = pkt_id;
-        slot.payload_len  = (len < 40) ? len : 40;
-        if (data && len > 0)
-            std::memcpy(slot.payload, data, slot.payload_len);
-        m_write_idx.store(w + 1, std::memory_order_release);
+        slot.payload_len  = len;
+        slot.flags        = 0;
+        seal(w);
+        --m_outstanding;
+        publish(w + slot.span);
         return true;
     }
 
-    bool read(RingSlot& out) noexcept {
-        size_t r = m_read_idx.load(std::memory_order_relaxed);
-        size_t w = m_write_idx.load(std::memory_order_acquire);
-        if (r == w) return false;
-        out = m_slots[r & m_mask];
-        m_read_idx.store(r + 1, std::memory_order_release);
-        return true;
+    // Payload da reserva mais antiga (nullptr se nenhuma pendente)
+    const uint8_t* pending() noexcept {
+        return m_outstanding ? payload_at(oldest_reserved()) : nullptr;
+    }
+
+    [[nodiscard]]
+    uint32_t outstanding() const noexcept { return m_outstanding; }
+
+    // peek - Proximo registro no lugar, sem copia (CONSUMIDOR).
+    // Payload contiguo em payload_of(*slot), payload_len bytes. Valido
+    // ate release(). nullptr se vazio.
+    const RingSlot* peek() noexcept {
+        size_t r = m_hdr->read_idx.load(std::memory_order_acquire);
+        for (;;) {
+            if (r == visible_end(r)) return nullptr;
+            const RingSlot& slot = m_slots[r & m_mask];
+            const size_t span = slot.span ? slot.span : 1;
+            if (slot.flags & RING_PAD) {
+                if (advance(r, r + span)) r += span;
+                continue;
+            }
+            m_peek_idx  = r;
+            m_peek_span = span;
+            return &slot;
+        }
+    }
+
+    // Payload de um slot no lugar (peek): depois do selo, se houver
+    const uint8_t* payload_of(const RingSlot& slot) const noexcept {
+        return slot.payload + (m_checksum ? RING_SEAL_BYTES : 0);
+    }
+
+    // release - Libera o registro de peek(). false: o produtor o
+    // sobrescreveu durante a leitura (write_overwrite), descarte-o.
+    bool release() noexcept {
+        size_t r = m_peek_idx;
+        return advance(r, r + m_peek_span);
+    }
+
+    // sync - Grava em disco slots e cabecalho (msync MS_SYNC) e
+    // avanca durable_write ate o write_idx atual (PRODUTOR). Apos
+    // queda do SO, RECOVER recupera ao menos o que foi publicado ate
+    // o ultimo sync(); queda so do processo nao perde nada publicado.
+    bool sync() noexcept {
+        if (m_consumer) return false;
+        const size_t w = m_hdr->write_idx.load(std::memory_order_relaxed);
+        if (msync(m_slots, m_capacity * sizeof(RingSlot), MS_SYNC) != 0) return false;
+        m_hdr->durable_write = w;
+        return msync(m_hdr, RING_HEADER_BYTES, MS_SYNC) == 0;
+    }
+
+    [[nodiscard]]
+    const RingRecovery& recovery() const noexcept { return m_recovery; }
+
+    [[nodiscard]]
+    platform::PageSize page_size() const noexcept { return m_map.page; }
+
+    // bind_node - Paginas do anel no no NUMA (de quem mais escreve,
+    // em geral o produtor). Migra as ja carregadas pelo construtor.
+    // Efeito pleno em tmpfs/shmem (/dev/shm); em arquivo de disco o
+    // page cache pode ignorar a politica. Um no so: no-op, true.
+    bool bind_node(int node) noexcept {
+        return platform::bind_to_node(m_map.ptr, m_map.bytes, node, true);
+    }
+
+    // Maior payload que um registro pode levar neste anel (VARIABLE:
+    // max_span() slots, metade da capacidade ate RING_MAX_SPAN)
+    size_t max_record() const noexcept {
+        return m_mode == RingMode::FIXED
+            ? inline_bytes()
+            : (max_span() - 1) * sizeof(RingSlot) + inline_bytes();
+    }
+
+    // Payload no primeiro slot: RING_INLINE_BYTES, ou
+    // RING_SEALED_INLINE_BYTES com RECOVER (selo seq/crc no slot)
+    uint32_t inline_bytes() const noexcept {
+        return m_checksum ? RING_SEALED_INLINE_BYTES : RING_INLINE_BYTES;
     }
 
+    // Slots ocupados (registros de varios slots contam cada slot)
     size_t size()     const noexcept {
-        return m_write_idx.load(std::memory_order_relaxed)
-             - m_read_idx.load(std::memory_order_relaxed);
+        return m_hdr->write_idx.load(std::memory_order_relaxed)
+             - m_hdr->read_idx.load(std::memory_order_relaxed);
     }
     size_t capacity() const noexcept { return m_capacity; }
     bool   empty()    const noexcept { return size() == 0; }
+    RingMode mode()   const noexcept { return m_mode; }
+    bool overwrites() const noexcept { return m_overwrite; }
 };
 
 } // namespace petronilho
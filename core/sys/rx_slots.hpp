@@ -0,0 +1,191 @@
+// Layer: L1 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// rx_slots.hpp - Slots de Recepcao Reciclados pelo Consumidor
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Os sinks que seguram o datagrama (QueueSink, BroadcastSink,
+// ShardedIngest) recebiam no lugar em slots carvados da Arena e,
+// com ela cheia, davam reset(): datagramas ainda na fila passavam
+// a apontar para memoria reescrita. RxSlots e um anel de N slots
+// de tamanho fixo, carvado uma vez, em que um slot so volta ao
+// backend depois que o consumidor o liberou:
+//
+//   acquire()      : slot livre, ja com uma referencia (o
+//                    emprestimo ao backend)
+//   publish(p, seg): datagrama em p publicado. O segmento 0 herda
+//                    o emprestimo; segmentos GRO seguintes somam
+//                    uma referencia cada
+//   unhold(i)      : produtor desistiu de uma referencia (descarte,
+//                    copia, sobrescrita)
+//   release(i)     : consumidor terminou de ler um datagrama de i
+//
+// Slot livre = published[i] == released[i]. Cada contador tem um
+// so escritor (load + store, sem RMW): published e do produtor,
+// released do consumidor. Um slot com o backend, ainda sem dados,
+// segue emprestado: nunca e entregue duas vezes.
+//
+// acquire() procura a partir da sequencia de entrega, ate
+// RX_SLOTS_PROBE slots: um datagrama antigo retido (consumidor
+// lento, descartes no meio da fila) nao trava os slots livres
+// depois dele.
+//
+// ANEL CHEIO: nenhum livre na janela. acquire() cede o slot de
+// descarte; o datagrama recebido nele e recusado (owns() == false)
+// e contado em exhausted(). Nada e reescrito sob um leitor: o
+// consumidor lento custa descartes, nao corrupcao.
+//
+// ALGORITMO: Fila Circular com Contagem de Referencias por Slot
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas circulares
+// O indice do slot e a sequencia de entrega mod N, como o tail
+// da fila do Cormen; o head vira a contagem de liberacoes.
+//
+// Complexidade: acquire O(1) (O(RX_SLOTS_PROBE) com o anel cheio),
+//               publish/unhold/release O(1)
+// Thread-safety: 1 produtor, 1 consumidor (ou o produtor)
+// ================================================================
+
+#pragma once
+#include "arena.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+namespace petronilho::net {
+
+    static constexpr uint32_t RX_SLOTS_MIN   = 256;
+    static constexpr uint32_t RX_SLOTS_PROBE = 64;   // janela do acquire
+
+    class RxSlots {
+    private:
+        uint8_t*               m_base;       // N slots contiguos
+        uint8_t*               m_discard;    // slot de descarte
+        uint32_t*              m_published;  // produtor
+        std::atomic<uint32_t>* m_released;   // consumidor
+        uint32_t               m_slot_bytes;
+        uint32_t               m_mask;
+        uint64_t               m_next;       // sequencia de entrega
+        uint64_t               m_exhausted;
+
+        static size_t footprint(uint32_t n, uint32_t slot_bytes) noexcept {
+            const size_t counters = ((size_t(n) * sizeof(uint32_t) + 63) & ~size_t(63));
+            return size_t(n + 1) * slot_bytes + 2 * counters;
+        }
+
+    public:
+        RxSlots() noexcept
+            : m_base(nullptr), m_discard(nullptr), m_published(nullptr)
+            , m_released(nullptr), m_slot_bytes(0), m_mask(0)
+            , m_next(0), m_exhausted(0) {}
+
+        RxSlots(const RxSlots&)            = delete;
+        RxSlots& operator=(const RxSlots&) = delete;
+
+        // ============================================================
+        // init - Carva o anel de uma vez da Arena
+        // slots: desejado (arredondado a potencia de 2); se a Arena
+        // nao comporta, o anel encolhe ate RX_SLOTS_MIN. false: nem
+        // isso cabe. A Arena nunca e consultada de novo.
+        // ============================================================
+        [[nodiscard]]
+        bool init(sys::ScalableArena& arena, uint32_t slot_bytes, uint32_t slots) noexcept {
+            if (m_base || slot_bytes == 0) return false;
+            slot_bytes = (slot_bytes + 63) & ~uint32_t(63);
+
+            uint32_t n = RX_SLOTS_MIN;
+            while (n < slots && n < (1u << 30)) n <<= 1;
+
+            // Pedido maior que o resto avancaria o offset alem da
+            // capacidade para sempre: confere antes de alocar
+            const size_t used = arena.used();
+            const size_t room = used < arena.capacity() ? arena.capacity() - used : 0;
+            while (n > RX_SLOTS_MIN && footprint(n, slot_bytes) + 64 > room) n >>= 1;
+            if (footprint(n, slot_bytes) + 64 > room) return false;
+
+            auto h = arena.allocate<uint8_t>(footprint(n, slot_bytes) + 63, sys::ArenaTag::NET);
+            if (h.is_null()) return false;
+            uint8_t* p = reinterpret_cast<uint8_t*>(
+                (reinterpret_cast<uintptr_t>(h.get_ptr()) + 63) & ~uintptr_t(63));
+
+            const size_t counters = ((size_t(n) * sizeof(uint32_t) + 63) & ~size_t(63));
+            m_base      = p;
+            m_discard   = p + size_t(n) * slot_bytes;
+            m_published = reinterpret_cast<uint32_t*>(m_discard + slot_bytes);
+            m_released  = reinterpret_cast<std::atomic<uint32_t>*>(
+                reinterpret_cast<uint8_t*>(m_published) + counters);
+            for (uint32_t i = 0; i < n; ++i) {
+                m_published[i] = 0;
+                ::new (&m_released[i]) std::atomic<uint32_t>(0);
+            }
+            m_slot_bytes = slot_bytes;
+            m_mask       = n - 1;
+            return true;
+        }
+
+        [[nodiscard]]
+        bool ready() const noexcept { return m_base != nullptr; }
+
+        // Proximo slot livre (emprestado ate o publish), ou o de
+        // descarte se a janela inteira esta retida
+        [[nodiscard]]
+        PETRONILHO_FORCE_INLINE uint8_t* acquire() noexcept {
+            for (uint32_t k = 0; k < RX_SLOTS_PROBE; ++k) {
+                const uint32_t i = static_cast<uint32_t>(m_next + k) & m_mask;
+                if (m_published[i] != m_released[i].load(std::memory_order_acquire))
+                    continue;
+                ++m_published[i];
+                m_next += k + 1;
+                return m_base + size_t(i) * m_slot_bytes;
+            }
+            return m_discard;
+        }
+
+        // p aponta para dentro de um slot do anel (nao o de descarte)
+        [[nodiscard]]
+        PETRONILHO_FORCE_INLINE bool owns(const void* p) const noexcept {
+            const uint8_t* b = static_cast<const uint8_t*>(p);
+            return b >= m_base && b < m_discard;
+        }
+
+        [[nodiscard]]
+        PETRONILHO_FORCE_INLINE uint32_t index_of(const void* p) const noexcept {
+            return static_cast<uint32_t>(
+                (static_cast<const uint8_t*>(p) - m_base) / m_slot_bytes);
+        }
+
+        // --- Produtor ---
+
+        // Datagrama do segmento seg do slot em p vai ser publicado:
+        // devolve o indice do slot (desfaca com unhold se recusado)
+        PETRONILHO_FORCE_INLINE uint32_t publish(const void* p, uint32_t seg) noexcept {
+            const uint32_t i = index_of(p);
+            if (seg != 0) ++m_published[i];
+            return i;
+        }
+
+        PETRONILHO_FORCE_INLINE void unhold(uint32_t i) noexcept { --m_published[i]; }
+
+        // Datagrama recebido no slot de descarte (anel cheio)
+        void refused() noexcept { ++m_exhausted; }
+
+        // --- Consumidor: payload do slot i nao e mais lido ---
+        PETRONILHO_FORCE_INLINE void release(uint32_t i) noexcept {
+            m_released[i].store(m_released[i].load(std::memory_order_relaxed) + 1,
+                                std::memory_order_release);
+        }
+
+        [[nodiscard]]
+        uint32_t slots() const noexcept { return m_base ? m_mask + 1 : 0; }
+
+        [[nodiscard]]
+        uint32_t slot_bytes() const noexcept { return m_slot_bytes; }
+
+        // Datagramas descartados porque o anel estava todo retido
+        [[nodiscard]]
+        uint64_t exhausted() const noexcept { return m_exhausted; }
+    };
+
+} // namespace petronilho::net
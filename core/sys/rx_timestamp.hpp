@@ -0,0 +1,101 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// rx_timestamp.hpp - Timestamp de Recepcao do Kernel (cmsg)
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Pede ao kernel que carimbe cada datagrama no momento em que
+// ele entra na pilha de rede (SO_TIMESTAMPING, software RX) e
+// le esse carimbo do cmsg devolvido por recvmsg/recvmmsg.
+//
+// POR QUE:
+// Medir o tempo dentro do recv() so mostra o custo da syscall.
+// O pacote pode ter esperado milissegundos na fila do socket.
+// Latencia kernel->usuario = agora(CLOCK_REALTIME) - carimbo RX,
+// que inclui a espera na fila: o numero que importa ao ajustar
+// lote (recvmmsg) e busy-poll.
+//
+// FALLBACK: SO_TIMESTAMPING indisponivel -> SO_TIMESTAMPNS.
+// Os dois usam CLOCK_REALTIME, o mesmo de realtime_ns().
+//
+// ALGORITMO: Busca Linear na lista de cmsg
+// BASE TEORICA: Cormen Cap.10 Sec.10.2 - Linked Lists
+// Os cmsg formam uma lista encadeada implicita (CMSG_NXTHDR).
+// Complexidade: O(c), c = numero de cmsg (tipicamente 1-2)
+// ================================================================
+
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <sys/socket.h>
+
+namespace petronilho::net {
+
+    enum class RxTimestampMode : uint8_t {
+        NONE        = 0,
+        TIMESTAMPNS = 1,  // SO_TIMESTAMPNS: struct timespec
+        TIMESTAMPING = 2  // SO_TIMESTAMPING: scm_timestamping.ts[0]
+    };
+
+    // Espaco de controle suficiente para o maior carimbo
+    static constexpr size_t RX_TIMESTAMP_CMSG_SPACE =
+        CMSG_SPACE(sizeof(scm_timestamping));
+
+    // ============================================================
+    // enable_rx_timestamps - Ativa carimbo RX em software
+    // Retorna o modo obtido (NONE se o kernel recusou ambos)
+    // ============================================================
+    [[nodiscard]]
+    inline RxTimestampMode enable_rx_timestamps(int fd) noexcept {
+        const int flags = SOF_TIMESTAMPING_RX_SOFTWARE
+                        | SOF_TIMESTAMPING_SOFTWARE;
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING,
+                       &flags, sizeof(flags)) == 0)
+            return RxTimestampMode::TIMESTAMPING;
+
+        const int one = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS,
+                       &one, sizeof(one)) == 0)
+            return RxTimestampMode::TIMESTAMPNS;
+
+        return RxTimestampMode::NONE;
+    }
+
+    // ============================================================
+    // rx_timestamp_ns - Extrai o carimbo RX do cmsg
+    // Cormen Sec.10.2: percorre a lista ate achar o tipo certo
+    // Retorna 0 se o datagrama veio sem carimbo
+    // ============================================================
+    [[nodiscard]]
+    inline uint64_t rx_timestamp_ns(const msghdr& msg) noexcept {
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c;
+             c = CMSG_NXTHDR(const_cast<msghdr*>(&msg), c)) {
+            if (c->cmsg_level != SOL_SOCKET) continue;
+
+            const timespec* ts = nullptr;
+            if (c->cmsg_type == SCM_TIMESTAMPING)
+                ts = &reinterpret_cast<const scm_timestamping*>(
+                        CMSG_DATA(c))->ts[0];
+            else if (c->cmsg_type == SCM_TIMESTAMPNS)
+                ts = reinterpret_cast<const timespec*>(CMSG_DATA(c));
+
+            if (ts && (ts->tv_sec | ts->tv_nsec))
+                return static_cast<uint64_t>(ts->tv_sec) * 1000000000ULL
+                     + static_cast<uint64_t>(ts->tv_nsec);
+        }
+        return 0;
+    }
+
+    // Relogio do carimbo RX (CLOCK_REALTIME), em ns
+    [[nodiscard]]
+    inline uint64_t realtime_ns() noexcept {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+             + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+} // namespace petronilho::net
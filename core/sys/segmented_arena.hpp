@@ -0,0 +1,206 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// segmented_arena.hpp - Arena Segmentada de 64 bits
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// ScalableArena e ArenaAtomic devolvem Handle<T> com offset de
+// 32 bits: no maximo 4GB por arena. Journals e indices em memoria
+// passam de 16GB. SegmentedArena endereca com WideHandle<T>
+// (segmento + offset) e cresce mapeando segmentos novos sob
+// demanda; os segmentos ja mapeados nunca se movem, entao
+// handles e ponteiros antigos continuam validos.
+//
+//   offset global (64 bits) = segmento * segment_bytes + offset
+//   segmento 0   [.........................]
+//   segmento 1   [.........................]  mapeado no 1o uso
+//   ...
+//
+// Alocacao: um fetch_add no offset global (como ArenaAtomic).
+// Uma alocacao que cruzaria o fim do segmento e abandonada e
+// refeita no seguinte: o desperdicio por segmento e menor que a
+// maior alocacao. Uma alocacao nunca e maior que um segmento.
+// O offset global e sempre multiplo de BASE_ALIGN; T com
+// alignof(T) maior pede align - BASE_ALIGN bytes a mais e o
+// inicio e arredondado dentro do pedaco (ate o alinhamento da
+// pagina, base de cada segmento).
+//
+// Segmento novo: quem chega primeiro mapeia e publica por CAS na
+// tabela; quem perde a corrida desfaz o proprio mapeamento.
+// reserve(bytes) mapeia antes do caminho quente (e pre-carrega
+// com populate = true).
+//
+// ALGORITMO: Tabela de Segmentos (enderecamento em dois niveis)
+// BASE TEORICA: Cormen Cap.17 Sec.17.4 - Dynamic Tables
+// Como a tabela dinamica, a capacidade cresce sob demanda; aqui
+// sem copia: cada expansao e um segmento novo, e o custo de
+// mapear e amortizado pelas alocacoes que cabem nele.
+//
+// Complexidade: allocate O(1) (um fetch_add; mmap no 1o uso do
+// segmento), get_ptr O(1)
+// Thread-safety: N threads alocando; reset() sem alocacoes em voo
+// ================================================================
+
+#pragma once
+#include "handle.hpp"
+#include "core/platform/huge_pages.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace petronilho::sys {
+
+    class SegmentedArena {
+    public:
+        static constexpr uint32_t MAX_SEGMENTS  = 4096;
+        static constexpr size_t   SEGMENT_1G    = 1ULL << 30;
+        static constexpr size_t   BASE_ALIGN    = 16;
+
+    private:
+        std::atomic<uint8_t*>     m_segments[MAX_SEGMENTS];
+        platform::PageMapping     m_maps[MAX_SEGMENTS];   // escrito por quem publicou
+        const size_t              m_segment_bytes;
+        const uint32_t            m_shift;
+        const uint32_t            m_max_segments;
+        const platform::PageHint  m_hint;
+        const bool                m_populate;
+        alignas(64) std::atomic<uint64_t> m_offset;
+        std::atomic<uint32_t>     m_mapped;
+
+        static uint32_t log2_of(size_t v) noexcept {
+            if (v > WIDE_OFFSET_MASK) return WIDE_OFFSET_BITS;
+            uint32_t s = 0;
+            while ((size_t(1) << s) < v) ++s;
+            return s;
+        }
+
+        // Segmento s mapeado (mapeia se preciso). false: mmap falhou
+        bool ensure_segment(uint32_t s) noexcept {
+            if (m_segments[s].load(std::memory_order_acquire)) return true;
+
+            platform::PageMapping m = platform::map_anonymous(m_segment_bytes, m_hint, m_populate);
+            if (!m.ok()) return false;
+
+            uint8_t* expected = nullptr;
+            if (!m_segments[s].compare_exchange_strong(expected, static_cast<uint8_t*>(m.ptr),
+                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                platform::unmap(m);   // outra thread publicou antes
+                return true;
+            }
+            m_maps[s] = m;
+            m_mapped.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+    public:
+        // segment_bytes: arredondado para potencia de 2 entre 2MB
+        // (permite THP/hugetlb) e 2^48. max_segments <= MAX_SEGMENTS.
+        // populate = false: paginas entram por page fault no 1o uso;
+        // use reserve() para pre-carregar fora do caminho quente.
+        explicit SegmentedArena(size_t segment_bytes = SEGMENT_1G,
+                                platform::PageHint hint = platform::PageHint::SMALL,
+                                uint32_t max_segments = MAX_SEGMENTS,
+                                bool populate = false) noexcept
+            : m_segment_bytes(size_t(1) << log2_of(segment_bytes < platform::PAGE_2M
+                                                   ? platform::PAGE_2M : segment_bytes))
+            , m_shift(log2_of(m_segment_bytes))
+            , m_max_segments(max_segments && max_segments < MAX_SEGMENTS ? max_segments : MAX_SEGMENTS)
+            , m_hint(hint)
+            , m_populate(populate)
+            , m_offset(0)
+            , m_mapped(0)
+        {
+            for (uint32_t i = 0; i < MAX_SEGMENTS; ++i)
+                m_segments[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~SegmentedArena() {
+            for (uint32_t i = 0; i < MAX_SEGMENTS; ++i)
+                if (m_maps[i].ok()) platform::unmap(m_maps[i]);
+        }
+
+        SegmentedArena(const SegmentedArena&)            = delete;
+        SegmentedArena& operator=(const SegmentedArena&) = delete;
+
+        // ============================================================
+        // allocate<T> - fetch_add no offset global de 64 bits
+        // Null: maior que um segmento, limite de segmentos ou mmap
+        // ============================================================
+        template<typename T>
+        [[nodiscard]]
+        WideHandle<T> allocate(size_t count = 1) noexcept {
+            static_assert(alignof(T) <= platform::PAGE_4K,
+                          "base do segmento so e alinhada a pagina");
+            const size_t align   = alignof(T) > BASE_ALIGN ? alignof(T) : BASE_ALIGN;
+            const size_t aligned = (sizeof(T) * count + (align - 1)) & ~(align - 1);
+            if (aligned == 0 || aligned > m_segment_bytes) return WideHandle<T>::null();
+
+            // Folga para arredondar o inicio: o offset global so e
+            // garantido multiplo de BASE_ALIGN
+            const size_t take = aligned + (align - BASE_ALIGN);
+            for (;;) {
+                const uint64_t got = m_offset.fetch_add(take, std::memory_order_relaxed);
+                const uint64_t off = (got + (align - 1)) & ~uint64_t(align - 1);
+                const uint64_t seg = off >> m_shift;
+                if (seg >= m_max_segments) return WideHandle<T>::null();
+
+                // Cruzaria o fim do segmento: abandona o pedaco e tenta
+                // de novo; o proximo fetch_add ja cai no segmento seguinte
+                const uint64_t in_seg = off & (m_segment_bytes - 1);
+                if (in_seg + aligned > m_segment_bytes) continue;
+
+                if (!ensure_segment(static_cast<uint32_t>(seg))) return WideHandle<T>::null();
+                return WideHandle<T>{
+                    WideHandle<T>::make_ref(static_cast<uint32_t>(seg), in_seg), m_segments };
+            }
+        }
+
+        // Mapeia os segmentos que cobrem [0, bytes). false: limite ou mmap
+        [[nodiscard]]
+        bool reserve(size_t bytes) noexcept {
+            const uint64_t n = (bytes + m_segment_bytes - 1) >> m_shift;
+            if (n > m_max_segments) return false;
+            for (uint32_t s = 0; s < n; ++s)
+                if (!ensure_segment(s)) return false;
+            return true;
+        }
+
+        // Rebobina o offset; os segmentos continuam mapeados e sao
+        // reaproveitados. Handles antigos passam a apontar para
+        // memoria que sera reescrita.
+        void reset() noexcept {
+            m_offset.store(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]]
+        uint64_t used() const noexcept {
+            const uint64_t off = m_offset.load(std::memory_order_relaxed);
+            const uint64_t cap = capacity();
+            return off < cap ? off : cap;
+        }
+
+        // Teto enderecavel (max_segments * segment_bytes)
+        [[nodiscard]]
+        uint64_t capacity() const noexcept {
+            return uint64_t(m_max_segments) << m_shift;
+        }
+
+        // Bytes ja mapeados
+        [[nodiscard]]
+        uint64_t mapped() const noexcept {
+            return uint64_t(m_mapped.load(std::memory_order_relaxed)) << m_shift;
+        }
+
+        [[nodiscard]]
+        uint32_t segments() const noexcept { return m_mapped.load(std::memory_order_relaxed); }
+
+        [[nodiscard]]
+        size_t segment_bytes() const noexcept { return m_segment_bytes; }
+
+        // Pagina do segmento 0 (4KB se ainda nao mapeado)
+        [[nodiscard]]
+        platform::PageSize page_size() const noexcept { return m_maps[0].page; }
+    };
+
+} // namespace petronilho::sys
@@ -0,0 +1,313 @@
+// Layer: L1 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// sharded_ingest.hpp - Motor de Ingestao Multi-Core por SO_REUSEPORT
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Abre N sockets na mesma porta com SO_REUSEPORT e dedica uma
+// thread fixada (pinned) a cada um. Cada shard e dono exclusivo
+// de tudo que toca no hot path:
+//   - seu socket
+//   - sua ScalableArena, sobre uma fatia propria do buffer global
+//   - sua NetworkQueue SPSC ate a camada de logica
+//   - seus contadores, numa cache line propria
+// Nenhuma cache line e escrita por dois cores de recepcao.
+// Os slots de datagrama sao um RxSlots (rx_slots.hpp) carvado da
+// fatia: um slot so volta a recepcao depois que o consumidor passou
+// por ele, entao nada na fila aponta para memoria reescrita.
+// Com mais de um no NUMA, a fatia da Arena e a fila do shard sao
+// migradas para o no da CPU do shard (numa.hpp).
+//
+// CONSUMO:
+// A camada de logica chama poll(shard, pkt) e le o payload via
+// payload(shard, pkt). O payload vale ate o proximo poll() do
+// mesmo shard, que devolve o slot. Cada fila continua SPSC: um
+// consumidor por shard (ou um consumidor que varre todos os shards).
+//
+// ALGORITMO: Particionamento por Hash (Sharding)
+// BASE TEORICA: Cormen Cap.11 - Hash Tables
+// O kernel aplica h(tupla) mod N para escolher o socket, como
+// uma tabela hash com encadeamento onde cada bucket e um core.
+// Fluxos distintos se espalham; um fluxo nunca muda de shard.
+//
+// Complexidade: O(1) amortizado por pacote em cada shard
+// ================================================================
+
+#pragma once
+#include "arena.hpp"
+#include "network_queue.hpp"
+#include "batch_receiver.hpp"
+#include "rx_slots.hpp"
+#include "udp_socket.hpp"
+#include "core/platform/platform_detect.hpp"
+#include "core/platform/numa.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace petronilho::net {
+
+    // Descritor publicado na fila do shard: offset na fatia da Arena
+    struct ShardPacket {
+        uint32_t offset;
+        uint32_t len;
+    };
+
+    // ============================================================
+    // ShardCounters - um escritor (thread do shard), N leitores
+    // bump() usa load + store relaxed: sem prefixo LOCK no x86
+    // ============================================================
+    struct alignas(64) ShardCounters {
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> syscalls{0};
+        std::atomic<uint64_t> queue_full{0};   // descartes por fila cheia
+        std::atomic<uint64_t> slots_full{0};   // descartes: slots retidos pelo consumidor
+        std::atomic<uint64_t> errors{0};
+        uint8_t               _pad[16];
+
+        static void bump(std::atomic<uint64_t>& c, uint64_t v = 1) noexcept {
+            c.store(c.load(std::memory_order_relaxed) + v,
+                    std::memory_order_relaxed);
+        }
+    };
+
+    static_assert(sizeof(ShardCounters) == 64,
+        "ShardCounters deve ocupar uma cache line");
+
+    template<uint32_t MaxShards, size_t QueueCapacity = 8192>
+    class ShardedIngest {
+    public:
+        static constexpr uint32_t SLOT_SIZE = 2048;  // >= 1472 + folga
+        static constexpr uint32_t MAX_BATCH = 32;
+
+        struct alignas(64) Shard {
+            NetworkQueue<ShardPacket, QueueCapacity> queue;
+            ShardCounters                            counters;
+
+            alignas(sys::ScalableArena)
+            uint8_t          arena_mem[sizeof(sys::ScalableArena)];
+            RxSlots          slots;
+            uint8_t*         base  = nullptr;
+            int              fd    = -1;
+            int              cpu   = -1;
+            uint32_t         index = 0;
+            pthread_t        thread{};
+            ShardedIngest*   owner = nullptr;
+
+            // Consumidor: slot do ultimo poll(), devolvido no proximo
+            alignas(64) int64_t held = -1;
+
+            sys::ScalableArena& arena() noexcept {
+                return *reinterpret_cast<sys::ScalableArena*>(arena_mem);
+            }
+        };
+
+    private:
+        Shard             m_shards[MaxShards];
+        uint32_t          m_count;
+        uint32_t          m_batch;
+        std::atomic<bool> m_running;
+
+        // Slots por shard: a fila cheia + o lote em voo
+        static constexpr uint32_t SLOTS = static_cast<uint32_t>(QueueCapacity) + 2 * MAX_BATCH;
+
+        // Fecha o que start() abriu nos shards [0, n), com as
+        // threads ja encerradas
+        void teardown(uint32_t n) noexcept {
+            for (uint32_t i = 0; i < n; ++i) {
+                Shard& s = m_shards[i];
+                close(s.fd);
+                s.fd = -1;
+                s.arena().~ScalableArena();
+                s.counters.packets.store(0,    std::memory_order_relaxed);
+                s.counters.bytes.store(0,      std::memory_order_relaxed);
+                s.counters.syscalls.store(0,   std::memory_order_relaxed);
+                s.counters.queue_full.store(0, std::memory_order_relaxed);
+                s.counters.slots_full.store(0, std::memory_order_relaxed);
+                s.counters.errors.store(0,     std::memory_order_relaxed);
+                ShardPacket drain;
+                while (s.queue.dequeue(drain)) {}
+            }
+        }
+
+        static void* rx_main(void* arg) noexcept {
+            Shard&         s    = *static_cast<Shard*>(arg);
+            ShardedIngest& self = *s.owner;
+
+            if (s.cpu >= 0) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(s.cpu, &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            }
+            sys::ScalableArena::initialize_thread();
+
+            BatchReceiver<MAX_BATCH> rx(self.m_batch);
+            for (uint32_t i = 0; i < rx.batch(); ++i)
+                rx.set_buffer(i, s.slots.acquire(), SLOT_SIZE);
+
+            while (self.m_running.load(std::memory_order_relaxed)) {
+                const int k = rx.receive(s.fd);
+                if (k <= 0) {
+                    if (k < 0) ShardCounters::bump(s.counters.errors);
+                    _mm_pause();
+                    continue;
+                }
+
+                uint64_t bytes = 0;
+                for (int i = 0; i < k; ++i) {
+                    const uint32_t len = rx.length(i);
+                    bytes += len;
+                    const uint8_t* buf = static_cast<const uint8_t*>(rx.buffer(i));
+                    if (!s.slots.owns(buf)) {
+                        s.slots.refused();
+                        ShardCounters::bump(s.counters.slots_full);
+                        continue;
+                    }
+                    const uint32_t slot = s.slots.publish(buf, 0);
+                    const ShardPacket pkt{
+                        static_cast<uint32_t>(buf - s.base), len };
+                    if (!s.queue.enqueue(pkt)) {
+                        s.slots.unhold(slot);
+                        ShardCounters::bump(s.counters.queue_full);
+                    }
+                }
+
+                ShardCounters::bump(s.counters.packets, k);
+                ShardCounters::bump(s.counters.bytes, bytes);
+                ShardCounters::bump(s.counters.syscalls);
+
+                for (uint32_t i = rx.consume(k); i < rx.batch(); ++i)
+                    rx.set_buffer(i, s.slots.acquire(), SLOT_SIZE);
+            }
+            return nullptr;
+        }
+
+    public:
+        ShardedIngest() noexcept
+            : m_count(0), m_batch(MAX_BATCH), m_running(false) {}
+
+        ShardedIngest(const ShardedIngest&)            = delete;
+        ShardedIngest& operator=(const ShardedIngest&) = delete;
+
+        ~ShardedIngest() noexcept { stop(); }
+
+        // ============================================================
+        // start - Abre 'shards' sockets SO_REUSEPORT e sobe as threads
+        //
+        // buffer/size: memoria total, fatiada igualmente entre shards
+        // first_cpu  : shard i fixado em (first_cpu + i) mod nproc;
+        //              -1 desativa o pinning
+        // Cada fatia precisa de RX_SLOTS_MIN slots de SLOT_SIZE
+        // (512KB); o anel cresce ate QueueCapacity + 2 lotes.
+        // Retorna false se algum socket, fatia ou thread falhar
+        // (nada fica rodando).
+        // ============================================================
+        [[nodiscard]]
+        bool start(uint32_t shards, uint16_t port,
+                   void* buffer, size_t size,
+                   int first_cpu = 0, uint32_t batch = MAX_BATCH) noexcept
+        {
+            if (m_count || shards == 0 || shards > MaxShards) return false;
+
+            const long ncpu  = sysconf(_SC_NPROCESSORS_ONLN);
+            const size_t cut = (size / shards) & ~size_t(63);
+            m_batch = batch;
+
+            for (uint32_t i = 0; i < shards; ++i) {
+                Shard& s = m_shards[i];
+                s.fd = open_udp_socket({ .port = port,
+                                         .non_blocking = true,
+                                         .reuse_port = true });
+                if (s.fd < 0) {
+                    teardown(i);
+                    return false;
+                }
+                s.base  = static_cast<uint8_t*>(buffer) + i * cut;
+                s.index = i;
+                s.owner = this;
+                s.cpu   = (first_cpu < 0 || ncpu <= 0)
+                        ? -1 : static_cast<int>((first_cpu + i) % ncpu);
+                // Buffer global costuma ser tocado (memset) pela thread
+                // principal: leva a fatia e a fila para o no do shard
+                if (s.cpu >= 0) {
+                    const int node = platform::node_of_cpu(s.cpu);
+                    (void)platform::bind_to_node(s.base, cut, node);
+                    (void)platform::bind_to_node(&s, sizeof(Shard), node);
+                }
+                new (s.arena_mem) sys::ScalableArena(s.base, cut);
+                new (&s.slots) RxSlots();
+                s.held = -1;
+                if (!s.slots.init(s.arena(), SLOT_SIZE, SLOTS)) {
+                    teardown(i + 1);
+                    return false;
+                }
+            }
+
+            m_running.store(true, std::memory_order_release);
+            for (uint32_t i = 0; i < shards; ++i) {
+                if (pthread_create(&m_shards[i].thread, nullptr,
+                                   rx_main, &m_shards[i]) != 0) {
+                    // Threads ja criadas saem no proximo giro do loop
+                    m_running.store(false, std::memory_order_release);
+                    for (uint32_t j = 0; j < i; ++j)
+                        pthread_join(m_shards[j].thread, nullptr);
+                    teardown(shards);
+                    return false;
+                }
+            }
+            m_count = shards;
+            return true;
+        }
+
+        void stop() noexcept {
+            if (!m_count) return;
+            m_running.store(false, std::memory_order_release);
+            for (uint32_t i = 0; i < m_count; ++i)
+                pthread_join(m_shards[i].thread, nullptr);
+            teardown(m_count);
+            m_count = 0;
+        }
+
+        // Consumidor do shard i (SPSC: uma thread por shard).
+        // Devolve o slot do pacote anterior: o payload dele nao
+        // pode mais ser lido.
+        [[nodiscard]]
+        bool poll(uint32_t shard, ShardPacket& out) noexcept {
+            Shard& s = m_shards[shard];
+            if (s.held >= 0) {
+                s.slots.release(static_cast<uint32_t>(s.held));
+                s.held = -1;
+            }
+            if (!s.queue.dequeue(out)) return false;
+            s.held = s.slots.index_of(s.base + out.offset);
+            return true;
+        }
+
+        [[nodiscard]]
+        const uint8_t* payload(uint32_t shard,
+                               const ShardPacket& pkt) const noexcept {
+            return m_shards[shard].base + pkt.offset;
+        }
+
+        [[nodiscard]]
+        const ShardCounters& counters(uint32_t shard) const noexcept {
+            return m_shards[shard].counters;
+        }
+
+        [[nodiscard]]
+        int cpu_of(uint32_t shard) const noexcept {
+            return m_shards[shard].cpu;
+        }
+
+        [[nodiscard]]
+        uint32_t shards() const noexcept { return m_count; }
+    };
+
+} // namespace petronilho::net
@@ -1,4 +1,4 @@
-// Layer: L0 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+// Layer: L0 | Version: 1.2.0 | Author: Fabio Petronilho de Oliveira
 //
 // ================================================================
 // telemetry.hpp - Leitura de Contador de Ciclos de CPU
@@ -23,6 +23,11 @@
 //   Sem barreira o CPU pode reordenar RDTSC (out-of-order)
 //   e a medicao fica imprecisa
 // - Adicionado rdtsc_end com RDTSCP para medicao de fim
+//
+// v1.2: calibrate_tsc / tsc_per_ns
+// Converte ciclos em nanossegundos medindo o TSC contra
+// CLOCK_MONOTONIC_RAW. Necessario para pacing por TSC e para
+// latencia de sondas (probe_header.hpp).
 // ================================================================
 
 #pragma once
@@ -69,4 +74,27 @@ namespace petronilho::sys {
         return petronilho::platform::rdtsc_end();
     }
 
+    // ============================================================
+    // calibrate_tsc - Ciclos de TSC por nanossegundo
+    // Janela de ms milissegundos contra now_ns (MONOTONIC_RAW).
+    // Supoe TSC invariante (constant_tsc, nonstop_tsc).
+    // ============================================================
+    [[nodiscard]]
+    inline double calibrate_tsc(uint32_t ms = 20) noexcept {
+        const uint64_t ns0  = petronilho::platform::now_ns();
+        const uint64_t tsc0 = read_tsc();
+        const uint64_t wait = static_cast<uint64_t>(ms) * 1000000ULL;
+        uint64_t ns1;
+        do { ns1 = petronilho::platform::now_ns(); } while (ns1 - ns0 < wait);
+        const uint64_t tsc1 = read_tsc();
+        return static_cast<double>(tsc1 - tsc0) / static_cast<double>(ns1 - ns0);
+    }
+
+    // Calibrado uma vez por processo, na primeira chamada
+    [[nodiscard]]
+    inline double tsc_per_ns() noexcept {
+        static const double ratio = calibrate_tsc();
+        return ratio;
+    }
+
 } // namespace petronilho::sys
\ No newline at end of file
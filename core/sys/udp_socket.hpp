@@ -0,0 +1,80 @@
+// Layer: L0 | Version: 1.1.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// udp_socket.hpp - Abertura de Socket UDP de Ingestao
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Centraliza socket() + fcntl() + setsockopt() + bind() que
+// cada loop de ingestao repetia a mao. Retorna o descritor
+// pronto para recv/recvmmsg ou -1 em falha, sem excecoes.
+//
+// SO_REUSEPORT (v1.1):
+// Varios sockets na mesma porta, um por core. O kernel distribui
+// os datagramas por hash da tupla (origem, destino), entao cada
+// fluxo cai sempre no mesmo socket e na mesma thread.
+//
+// ALGORITMO: Sequencia fixa de chamadas de sistema
+// BASE TEORICA: Cormen Cap.1 - modelo de custo uniforme
+// Executado uma vez no boot, fora do hot path.
+// Complexidade: O(1)
+// ================================================================
+
+#pragma once
+#include <cstdint>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace petronilho::net {
+
+    struct UdpSocketConfig {
+        uint16_t port         = 9999;
+        bool     non_blocking = true;
+        int      rcvbuf_bytes = 0;    // 0 = padrao do kernel
+        bool     reuse_port   = false; // sharding multi-core
+    };
+
+    // ============================================================
+    // open_udp_socket - socket + bind em INADDR_ANY:port
+    // Retorna fd >= 0 ou -1 (errno preservado da chamada que falhou)
+    // ============================================================
+    [[nodiscard]]
+    inline int open_udp_socket(const UdpSocketConfig& cfg) noexcept {
+        const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) return -1;
+
+        if (cfg.non_blocking) {
+            const int flags = fcntl(fd, F_GETFL, 0);
+            fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        }
+
+        if (cfg.reuse_port) {
+            const int one = 1;
+            if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+                           &one, sizeof(one)) < 0) {
+                close(fd);
+                return -1;
+            }
+        }
+
+        if (cfg.rcvbuf_bytes > 0) {
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF,
+                       &cfg.rcvbuf_bytes, sizeof(cfg.rcvbuf_bytes));
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port        = htons(cfg.port);
+
+        if (bind(fd, reinterpret_cast<const sockaddr*>(&addr),
+                 sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+} // namespace petronilho::net
@@ -0,0 +1,252 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// uring_receiver.hpp - Ingestao io_uring Multishot com Buffer Ring
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Arma UM recv multishot no socket. O kernel escolhe sozinho um
+// buffer livre do buffer ring (grupo BGID) para cada datagrama e
+// gera uma CQE com o buffer ID. Nenhuma SQE por pacote, nenhuma
+// syscall por pacote: o loop so colhe CQEs em lote.
+//
+// MEMORIA:
+// Os buffers de pacote sao um unico bloco contiguo carvado da
+// ScalableArena: buffer(bid) = base + bid * buf_size. O anel de
+// descritores (16 bytes por entrada) vem de io_uring_setup_buf_ring,
+// que exige alinhamento de pagina que a Arena nao garante.
+//
+// CICLO DE VIDA DE UM BUFFER:
+//   kernel preenche -> reap() entrega bid -> consumidor usa ->
+//   recycle(bid) devolve ao anel.
+// recycle() so pode ser chamado pela thread dona do io_uring.
+// Consumidores em outra thread devolvem o bid por uma fila
+// (NetworkQueue) que a thread de ingestao drena.
+//
+// ALGORITMO: Anel de Buffers Provido + Colheita em Lote
+// BASE TEORICA: Cormen Cap.10 Sec.10.1 - Filas circulares
+//               Cormen Cap.17 - Analise Amortizada
+// O buffer ring e uma fila circular produtor (usuario) /
+// consumidor (kernel). A colheita de ate REAP_BATCH CQEs por
+// io_uring_cq_advance amortiza o custo de sincronizacao.
+//
+// REQUISITO: liburing >= 2.4, kernel >= 6.0 (recv multishot)
+// Complexidade: reap O(k) para k CQEs, recycle O(1)
+// ================================================================
+
+#pragma once
+#include "arena.hpp"
+#include <liburing.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+namespace petronilho::net {
+
+    template<uint32_t Entries>
+    class UringReceiver {
+    private:
+        static_assert((Entries & (Entries - 1)) == 0,
+            "Entries deve ser potencia de 2");
+        static_assert(Entries >= 2 && Entries <= 32768,
+            "buffer ring aceita de 2 a 32768 entradas");
+
+        static constexpr int      BGID       = 0;
+        static constexpr uint64_t RECV_TAG   = 0x1;
+        static constexpr uint32_t REAP_BATCH = 64;
+
+        io_uring            m_ring;
+        io_uring_buf_ring*  m_br;
+        uint8_t*            m_buffers;
+        uint32_t            m_buf_size;
+        int                 m_fd;
+        int                 m_pending;  // recycles ainda nao publicados
+        bool                m_ready;
+        bool                m_armed;
+
+        uint64_t            m_reaps;        // colheitas com >= 1 CQE
+        uint64_t            m_completions;  // datagramas entregues
+        uint64_t            m_rearms;       // multishot terminou e foi rearmado
+        uint64_t            m_no_buffers;   // -ENOBUFS: anel vazio
+
+        void arm() noexcept {
+            io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+            if (!sqe) return;
+            io_uring_prep_recv_multishot(sqe, m_fd, nullptr, 0, 0);
+            sqe->flags     |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group  = BGID;
+            io_uring_sqe_set_data64(sqe, RECV_TAG);
+            m_armed = true;
+        }
+
+        void add_buffer(uint16_t bid) noexcept {
+            io_uring_buf_ring_add(m_br, buffer(bid), m_buf_size, bid,
+                io_uring_buf_ring_mask(Entries), m_pending++);
+        }
+
+        void publish_recycled() noexcept {
+            if (m_pending == 0) return;
+            io_uring_buf_ring_advance(m_br, m_pending);
+            m_pending = 0;
+        }
+
+    public:
+        UringReceiver() noexcept
+            : m_br(nullptr), m_buffers(nullptr), m_buf_size(0)
+            , m_fd(-1), m_pending(0), m_ready(false), m_armed(false)
+            , m_reaps(0), m_completions(0), m_rearms(0), m_no_buffers(0)
+        {}
+
+        UringReceiver(const UringReceiver&)            = delete;
+        UringReceiver& operator=(const UringReceiver&) = delete;
+
+        ~UringReceiver() noexcept {
+            if (!m_ready) return;
+            io_uring_free_buf_ring(&m_ring, m_br, Entries, BGID);
+            io_uring_queue_exit(&m_ring);
+        }
+
+        // ============================================================
+        // init - Cria o io_uring e o buffer ring, carva Entries
+        // buffers da Arena e os registra. Retorna false em falha
+        // (errno). A Arena so e tocada com o anel pronto: uma falha
+        // do kernel nao consome memoria (a Arena nao devolve blocos)
+        // e init() pode ser repetido.
+        // ============================================================
+        [[nodiscard]]
+        bool init(int fd, sys::ScalableArena& arena,
+                  uint32_t buf_size, uint32_t sq_entries = 256) noexcept
+        {
+            if (m_ready) { errno = EBUSY; return false; }
+
+            const int err = io_uring_queue_init(sq_entries, &m_ring, 0);
+            if (err < 0) { errno = -err; return false; }
+
+            int ret = 0;
+            m_br = io_uring_setup_buf_ring(&m_ring, Entries, BGID, 0, &ret);
+            if (!m_br) {
+                io_uring_queue_exit(&m_ring);
+                errno = -ret;
+                return false;
+            }
+
+            auto h = arena.allocate<uint8_t>(
+                static_cast<size_t>(Entries) * buf_size, sys::ArenaTag::NET);
+            if (h.is_null()) {
+                io_uring_free_buf_ring(&m_ring, m_br, Entries, BGID);
+                io_uring_queue_exit(&m_ring);
+                m_br  = nullptr;
+                errno = ENOMEM;
+                return false;
+            }
+
+            m_buffers  = h.get_ptr();
+            m_buf_size = buf_size;
+            m_fd       = fd;
+            m_ready    = true;
+
+            for (uint32_t bid = 0; bid < Entries; ++bid)
+                add_buffer(static_cast<uint16_t>(bid));
+            publish_recycled();
+            return true;
+        }
+
+        // ============================================================
+        // reap - Colhe CQEs em lote
+        //
+        // on_packet(bid, data, len) para cada datagrama.
+        // on_other(user_data, res) para CQEs que o chamador submeteu
+        // por ring() (ex.: escrita em disco).
+        // wait_ns > 0 bloqueia ate a primeira CQE ou timeout.
+        // Retorna o numero de CQEs consumidas.
+        // ============================================================
+        template<typename OnPacket, typename OnOther>
+        uint32_t reap(OnPacket&& on_packet, OnOther&& on_other,
+                      uint64_t wait_ns = 0) noexcept
+        {
+            publish_recycled();
+            if (!m_armed) { arm(); ++m_rearms; }
+
+            io_uring_submit(&m_ring);
+
+            if (wait_ns && io_uring_cq_ready(&m_ring) == 0) {
+                __kernel_timespec ts{
+                    static_cast<long long>(wait_ns / 1000000000ULL),
+                    static_cast<long long>(wait_ns % 1000000000ULL) };
+                io_uring_cqe* first = nullptr;
+                io_uring_wait_cqe_timeout(&m_ring, &first, &ts);
+            }
+
+            io_uring_cqe* cqes[REAP_BATCH];
+            const uint32_t n =
+                io_uring_peek_batch_cqe(&m_ring, cqes, REAP_BATCH);
+
+            for (uint32_t i = 0; i < n; ++i) {
+                io_uring_cqe* cqe = cqes[i];
+
+                if (io_uring_cqe_get_data64(cqe) != RECV_TAG) {
+                    on_other(io_uring_cqe_get_data64(cqe), cqe->res);
+                    continue;
+                }
+
+                if (!(cqe->flags & IORING_CQE_F_MORE))
+                    m_armed = false;
+
+                if (cqe->res == -ENOBUFS) { ++m_no_buffers; continue; }
+
+                if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+                    const uint16_t bid = static_cast<uint16_t>(
+                        cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                    ++m_completions;
+                    on_packet(bid, buffer(bid),
+                              static_cast<uint32_t>(cqe->res));
+                }
+            }
+
+            if (n) {
+                io_uring_cq_advance(&m_ring, n);
+                ++m_reaps;
+            }
+            return n;
+        }
+
+        // Devolve um buffer ao anel. Publicado no proximo reap().
+        void recycle(uint16_t bid) noexcept { add_buffer(bid); }
+
+        // Acesso ao io_uring para SQEs do chamador (ex.: escrita)
+        [[nodiscard]]
+        io_uring& ring() noexcept { return m_ring; }
+
+        [[nodiscard]]
+        uint8_t* buffer(uint16_t bid) const noexcept {
+            return m_buffers + static_cast<size_t>(bid) * m_buf_size;
+        }
+
+        [[nodiscard]]
+        uint8_t* buffer_base() const noexcept { return m_buffers; }
+
+        [[nodiscard]]
+        uint32_t buffer_size() const noexcept { return m_buf_size; }
+
+        [[nodiscard]]
+        uint64_t completions() const noexcept { return m_completions; }
+
+        [[nodiscard]]
+        uint64_t reaps() const noexcept { return m_reaps; }
+
+        [[nodiscard]]
+        uint64_t rearms() const noexcept { return m_rearms; }
+
+        [[nodiscard]]
+        uint64_t no_buffer_events() const noexcept { return m_no_buffers; }
+
+        // Cormen Cap.17: CQEs por colheita (custo amortizado)
+        [[nodiscard]]
+        double completions_per_reap() const noexcept {
+            return m_reaps
+                ? static_cast<double>(m_completions) / m_reaps
+                : 0.0;
+        }
+    };
+
+} // namespace petronilho::net
@@ -0,0 +1,239 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// wait_strategy.hpp - Estrategias de Espera do Loop de Recepcao
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Decide o que a thread de ingestao faz quando o socket (nao
+// bloqueante) devolve EAGAIN. Quatro estrategias plugaveis em
+// tempo de compilacao, mesma interface:
+//
+//   attach(fd)   - prepara o socket (SO_BUSY_POLL, epoll)
+//   idle()       - chamada a cada receive() vazio
+//   on_data(k)   - chamada quando um lote de k pacotes chegou
+//   histogram()  - latencia kernel->usuario sob esta estrategia
+//
+//   SpinWait     : pause e tenta de novo. Menor latencia, 100% CPU.
+//   BusyPollWait : SO_BUSY_POLL no socket: cada recv nao
+//                  bloqueante faz polling da fila NAPI do driver
+//                  antes de devolver EAGAIN. 100% CPU.
+//   BlockingWait : epoll_wait ate chegar dado. ~0% CPU ocioso,
+//                  paga o custo de acordar (wakeup) por rajada.
+//   AdaptiveWait : spin (orcamento) -> busy-poll (orcamento) ->
+//                  epoll; qualquer pacote volta direto ao spin.
+//
+// Cada estrategia carrega seu LatencyHistogram: o loop registra
+// a latencia de cada pacote nele e o relatorio compara P50/P99
+// e uso de CPU por estrategia, uma por deploy.
+//
+// ALGORITMO: Maquina de Estados (AdaptiveWait)
+// BASE TEORICA: Cormen Cap.17 Sec.17.4 - Dynamic Tables
+// Como a tabela dinamica que so muda de tamanho quando o fator
+// de carga cruza um limiar, a espera so escala para um estado
+// mais caro de acordar depois de um orcamento de tentativas
+// vazias. O custo da transicao (uma syscall) e amortizado pelas
+// tentativas que a precederam.
+//
+// Complexidade: idle O(1); BlockingWait bloqueia ate timeout
+// ================================================================
+
+#pragma once
+#include "latency_histogram.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <cstdint>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace petronilho::net {
+
+    struct WaitConfig {
+        uint32_t spin_budget      = 2048; // receives vazios em spin
+        uint32_t busy_poll_budget = 256;  // receives vazios em busy-poll
+        int      busy_poll_us     = 50;   // SO_BUSY_POLL por recv
+        int      block_timeout_ms = 100;  // teto do epoll_wait
+    };
+
+    struct WaitCounters {
+        uint64_t idle_calls  = 0;  // receives vazios
+        uint64_t blocks      = 0;  // epoll_wait executados
+        uint64_t escalations = 0;  // spin->busy ou busy->block
+        uint64_t bursts      = 0;  // volta ao spin por chegada de dado
+    };
+
+    // ============================================================
+    // Base comum: histograma + contadores + epoll sob demanda
+    // ============================================================
+    class WaitBase {
+    protected:
+        sys::LatencyHistogram m_hist;
+        WaitCounters          m_counters;
+        WaitConfig            m_cfg;
+        int                   m_fd    = -1;
+        int                   m_epoll = -1;
+
+        bool open_epoll() noexcept {
+            m_epoll = epoll_create1(EPOLL_CLOEXEC);
+            if (m_epoll < 0) return false;
+            epoll_event ev{};
+            ev.events  = EPOLLIN;
+            ev.data.fd = m_fd;
+            return epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_fd, &ev) == 0;
+        }
+
+        void block() noexcept {
+            epoll_event ev;
+            ++m_counters.blocks;
+            epoll_wait(m_epoll, &ev, 1, m_cfg.block_timeout_ms);
+        }
+
+        bool set_busy_poll(int usec) noexcept {
+            return setsockopt(m_fd, SOL_SOCKET, SO_BUSY_POLL,
+                              &usec, sizeof(usec)) == 0;
+        }
+
+    public:
+        explicit WaitBase(const WaitConfig& cfg) noexcept : m_cfg(cfg) {}
+
+        WaitBase(const WaitBase&)            = delete;
+        WaitBase& operator=(const WaitBase&) = delete;
+
+        ~WaitBase() noexcept { if (m_epoll >= 0) close(m_epoll); }
+
+        [[nodiscard]]
+        sys::LatencyHistogram& histogram() noexcept { return m_hist; }
+
+        [[nodiscard]]
+        const WaitCounters& counters() const noexcept { return m_counters; }
+    };
+
+    // ============================================================
+    // SpinWait - pause e tenta de novo
+    // ============================================================
+    class SpinWait : public WaitBase {
+    public:
+        static constexpr const char* NAME = "spin";
+
+        explicit SpinWait(const WaitConfig& cfg = {}) noexcept
+            : WaitBase(cfg) {}
+
+        bool attach(int fd) noexcept { m_fd = fd; return true; }
+
+        PETRONILHO_FORCE_INLINE void idle() noexcept {
+            ++m_counters.idle_calls;
+            _mm_pause();
+        }
+
+        PETRONILHO_FORCE_INLINE void on_data(uint32_t) noexcept {}
+    };
+
+    // ============================================================
+    // BusyPollWait - o proprio recv faz polling do driver
+    // Requer CAP_NET_ADMIN para subir acima de net.core.busy_read
+    // ============================================================
+    class BusyPollWait : public WaitBase {
+    public:
+        static constexpr const char* NAME = "busy-poll";
+
+        explicit BusyPollWait(const WaitConfig& cfg = {}) noexcept
+            : WaitBase(cfg) {}
+
+        bool attach(int fd) noexcept {
+            m_fd = fd;
+            return set_busy_poll(m_cfg.busy_poll_us);
+        }
+
+        PETRONILHO_FORCE_INLINE void idle() noexcept {
+            ++m_counters.idle_calls;
+        }
+
+        PETRONILHO_FORCE_INLINE void on_data(uint32_t) noexcept {}
+    };
+
+    // ============================================================
+    // BlockingWait - dorme no epoll ate chegar dado
+    // ============================================================
+    class BlockingWait : public WaitBase {
+    public:
+        static constexpr const char* NAME = "blocking";
+
+        explicit BlockingWait(const WaitConfig& cfg = {}) noexcept
+            : WaitBase(cfg) {}
+
+        bool attach(int fd) noexcept { m_fd = fd; return open_epoll(); }
+
+        void idle() noexcept {
+            ++m_counters.idle_calls;
+            block();
+        }
+
+        PETRONILHO_FORCE_INLINE void on_data(uint32_t) noexcept {}
+    };
+
+    // ============================================================
+    // AdaptiveWait - spin -> busy-poll -> epoll, volta no burst
+    // ============================================================
+    class AdaptiveWait : public WaitBase {
+    private:
+        enum class Stage : uint8_t { SPIN, BUSY_POLL, BLOCK };
+
+        Stage    m_stage    = Stage::SPIN;
+        uint32_t m_empty    = 0;     // receives vazios no estagio atual
+        bool     m_busy_ok  = false; // SO_BUSY_POLL permitido
+
+        void escalate(Stage next) noexcept {
+            ++m_counters.escalations;
+            if (next == Stage::BUSY_POLL && !m_busy_ok)
+                next = Stage::BLOCK;
+            if (next == Stage::BUSY_POLL)
+                set_busy_poll(m_cfg.busy_poll_us);
+            else if (m_stage == Stage::BUSY_POLL)
+                set_busy_poll(0);
+            m_stage = next;
+            m_empty = 0;
+        }
+
+    public:
+        static constexpr const char* NAME = "adaptive";
+
+        explicit AdaptiveWait(const WaitConfig& cfg = {}) noexcept
+            : WaitBase(cfg) {}
+
+        bool attach(int fd) noexcept {
+            m_fd = fd;
+            // Testa a permissao uma vez; o estagio so liga quando usado
+            m_busy_ok = set_busy_poll(m_cfg.busy_poll_us) && set_busy_poll(0);
+            return open_epoll();
+        }
+
+        void idle() noexcept {
+            ++m_counters.idle_calls;
+            switch (m_stage) {
+            case Stage::SPIN:
+                _mm_pause();
+                if (++m_empty >= m_cfg.spin_budget)
+                    escalate(Stage::BUSY_POLL);
+                break;
+            case Stage::BUSY_POLL:
+                if (++m_empty >= m_cfg.busy_poll_budget)
+                    escalate(Stage::BLOCK);
+                break;
+            case Stage::BLOCK:
+                block();
+                break;
+            }
+        }
+
+        // Chegada de dado: rajada provavel, volta ao estado mais barato
+        PETRONILHO_FORCE_INLINE void on_data(uint32_t) noexcept {
+            if (m_stage != Stage::SPIN) {
+                ++m_counters.bursts;
+                if (m_stage == Stage::BUSY_POLL) set_busy_poll(0);
+                m_stage = Stage::SPIN;
+            }
+            m_empty = 0;
+        }
+    };
+
+} // namespace petronilho::net
@@ -0,0 +1,162 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// bench_backpressure.cpp - Politicas de Transbordo sob Rajadas
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Mesmo motor (recvmmsg -> QueueSink<1024, Policy> -> logica lenta)
+// recebendo rajadas curtas muito acima da vazao da logica. Para
+// cada politica de backpressure.hpp imprime onde cada datagrama
+// enviado terminou:
+//
+//   kernel    : descartado no socket (nunca chegou ao recvmmsg)
+//   politica  : descartado/sobrescrito pela politica
+//   entregue  : processado pela thread de logica
+//
+// O objetivo das politicas block e spill e tirar a perda do
+// kernel (invisivel para a aplicacao) e, no spill, eliminar a
+// perda: a rajada vai para o arquivo e volta quando a logica
+// alcanca.
+//
+// Uso: bench_backpressure [rajadas] [pacotes por rajada] [rcvbuf KB]
+// ================================================================
+
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
+#include "core/sys/backpressure.hpp"
+#include "core/sys/persistent_arena.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/udp_socket.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+using namespace petronilho;
+
+static constexpr uint16_t PORT        = 9999;
+static constexpr size_t   QUEUE_CAP   = 1024;
+static constexpr size_t   ARENA_SIZE  = 32ULL * 1024 * 1024;
+static constexpr size_t   SPILL_SIZE  = 128ULL * 1024 * 1024;
+static constexpr uint32_t WORK_PAUSES = 200;   // custo da logica por item
+
+static int g_rcvbuf = 256 * 1024;
+
+static uint8_t g_arena_mem[ARENA_SIZE] __attribute__((aligned(4096)));
+
+struct BurstResult {
+    uint64_t sent;
+    uint64_t received;   // entregues pelo kernel ao motor
+    uint64_t delivered;  // processados pela logica
+};
+
+static void burst_sender(uint32_t bursts, uint32_t per_burst, std::atomic<uint64_t>* sent) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in dst{};
+    dst.sin_family      = AF_INET;
+    dst.sin_port        = htons(PORT);
+    dst.sin_addr.s_addr = inet_addr("127.0.0.1");
+    connect(fd, (const sockaddr*)&dst, sizeof(dst));
+
+    char payload[256];
+    std::memset(payload, 'P', sizeof(payload));
+    for (uint32_t b = 0; b < bursts; ++b) {
+        for (uint32_t i = 0; i < per_burst; ++i)
+            if (send(fd, payload, sizeof(payload), 0) > 0)
+                sent->fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
+    close(fd);
+}
+
+template<typename Sink>
+static void slow_logic(Sink* sink, std::atomic<uint64_t>* delivered, std::atomic<bool>* running) {
+    net::Datagram d;
+    for (;;) {
+        if (!sink->pop(d)) {
+            if (!running->load(std::memory_order_acquire)) break;
+            _mm_pause();
+            continue;
+        }
+        for (uint32_t i = 0; i < WORK_PAUSES; ++i) _mm_pause();
+        sink->done(d);
+        delivered->fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename Policy>
+static BurstResult run_policy(Policy policy, uint32_t bursts, uint32_t per_burst,
+                              uint64_t& policy_loss) {
+    net::UdpSocketConfig cfg;
+    cfg.port         = PORT;
+    cfg.rcvbuf_bytes = g_rcvbuf;
+    const int fd = net::open_udp_socket(cfg);
+
+    sys::ScalableArena arena(g_arena_mem, sizeof(g_arena_mem));
+    typedef net::QueueSink<QUEUE_CAP, Policy> Sink;
+    auto sink = std::make_unique<Sink>(arena, policy);
+    net::RecvmmsgBackend<32> backend(fd, 32, 512);
+    net::SpinWait wait;
+    net::IngestEngine<net::RecvmmsgBackend<32>, Sink, net::SpinWait> engine(backend, *sink, wait);
+    (void)engine.attach();
+
+    std::atomic<uint64_t> sent{0}, delivered{0};
+    std::atomic<bool> ingesting{true}, consuming{true};
+    std::thread logic(slow_logic<Sink>, sink.get(), &delivered, &consuming);
+    std::thread tx(burst_sender, bursts, per_burst, &sent);
+    std::thread rx([&] { engine.run([&] { return ingesting.load(std::memory_order_relaxed); }); });
+
+    tx.join();
+    // Ultima rajada: espera a logica e o transbordo esvaziarem
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ingesting = false;
+    rx.join();
+    consuming.store(false, std::memory_order_release);
+    logic.join();
+    close(fd);
+
+    const auto& c = sink->policy().counters();
+    if constexpr (std::is_same_v<Policy, net::DropNewest>)       policy_loss = c.dropped;
+    else if constexpr (std::is_same_v<Policy, net::DropOldest>)  policy_loss = c.overwritten + c.dropped;
+    else if constexpr (std::is_same_v<Policy, net::BlockWithTimeout>) policy_loss = c.timeouts;
+    else                                                         policy_loss = c.spill_full;
+
+    return BurstResult{ sent.load(), engine.stats().packets, delivered.load() };
+}
+
+template<typename Policy>
+static void report(Policy policy, uint32_t bursts, uint32_t per_burst) {
+    uint64_t policy_loss = 0;
+    const BurstResult r = run_policy(policy, bursts, per_burst, policy_loss);
+    std::cout << std::setw(12) << Policy::NAME << " | "
+              << std::setw(8) << r.sent << " | "
+              << std::setw(8) << (r.sent - r.received) << " | "
+              << std::setw(8) << policy_loss << " | "
+              << std::setw(8) << r.delivered << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t bursts    = (argc > 1) ? (uint32_t)std::atoi(argv[1]) : 5;
+    const uint32_t per_burst = (argc > 2) ? (uint32_t)std::atoi(argv[2]) : 20000;
+    if (argc > 3) g_rcvbuf = std::atoi(argv[3]) * 1024;
+
+    std::cout << "[BACKPRESSURE] " << bursts << " rajadas de " << per_burst
+              << " | fila " << QUEUE_CAP << " | rcvbuf " << g_rcvbuf / 1024 << "KB\n";
+    std::cout << "    politica |   enviado |   kernel | politica | entregue\n";
+
+    report(net::DropNewest(), bursts, per_burst);
+    report(net::DropOldest(), bursts, per_burst);
+    report(net::BlockWithTimeout(200000), bursts, per_burst);
+    {
+        PersistentArena spill_file("bench_spill.bin", SPILL_SIZE);
+        report(net::Spill(spill_file), bursts, per_burst);
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// bench_broadcast_ring.cpp - BroadcastRing vs N NetworkQueues
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Entrega o mesmo fluxo de descritores a N consumidores de duas
+// formas e mede descritores/s do produtor:
+//
+//   fanout    : uma NetworkQueue por consumidor; o produtor
+//               enfileira (copia) cada descritor N vezes.
+//   broadcast : um BroadcastRing (slots na ScalableArena); o
+//               produtor publica uma vez, em lotes de BATCH,
+//               cada consumidor anda com o proprio cursor.
+//
+// Cada consumidor confere a ordem das sequencias recebidas.
+//
+// Uso: bench_broadcast_ring [consumidores] [milhoes]
+// ================================================================
+
+#include "core/sys/broadcast_ring.hpp"
+#include "core/sys/network_queue.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <sched.h>
+
+using namespace petronilho;
+
+static constexpr size_t   CAPACITY      = 16384;
+static constexpr uint32_t MAX_CONSUMERS = 8;
+static constexpr uint32_t BATCH         = 64;
+
+struct Desc {
+    uint64_t seq;
+    uint32_t offset;
+    uint32_t len;
+};
+
+typedef net::NetworkQueue<Desc, CAPACITY>                    Queue;
+typedef net::BroadcastRing<Desc, CAPACITY, MAX_CONSUMERS>    Ring;
+
+static uint8_t g_arena_mem[8 * 1024 * 1024] __attribute__((aligned(4096)));
+
+static void idle(uint32_t& spins) {
+    if (++spins < 64) { _mm_pause(); return; }
+    spins = 0;
+    sched_yield();
+}
+
+static double run_fanout(uint32_t n, uint64_t total) {
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (uint32_t i = 0; i < n; ++i) queues.emplace_back(std::make_unique<Queue>());
+
+    std::vector<uint64_t> errors(n, 0);
+    std::vector<std::thread> consumers;
+    for (uint32_t c = 0; c < n; ++c)
+        consumers.emplace_back([&, c] {
+            Desc d;
+            uint32_t spins = 0;
+            for (uint64_t expect = 0; expect < total;) {
+                if (!queues[c]->dequeue(d)) { idle(spins); continue; }
+                if (d.seq != expect) errors[c]++;
+                expect++;
+            }
+        });
+
+    const auto t0 = std::chrono::steady_clock::now();
+    uint32_t spins = 0;
+    for (uint64_t s = 0; s < total; ++s) {
+        const Desc d{ s, (uint32_t)(s * 64), 64 };
+        for (uint32_t c = 0; c < n; ++c)
+            while (!queues[c]->enqueue(d)) idle(spins);
+    }
+    for (auto& t : consumers) t.join();
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    for (uint32_t c = 0; c < n; ++c)
+        if (errors[c]) std::cout << "[FANOUT] consumidor " << c << " fora de ordem: " << errors[c] << "\n";
+    return total / secs / 1e6;
+}
+
+static double run_broadcast(uint32_t n, uint64_t total) {
+    sys::ScalableArena arena(g_arena_mem, sizeof(g_arena_mem));
+    auto ring = std::make_unique<Ring>();
+    if (!ring->init(arena, n)) return 0.0;
+
+    std::vector<uint64_t> errors(n, 0);
+    std::vector<std::thread> consumers;
+    for (uint32_t c = 0; c < n; ++c)
+        consumers.emplace_back([&, c] {
+            uint64_t expect = 0;
+            uint32_t spins  = 0;
+            while (expect < total) {
+                const uint32_t k = ring->consume(c, [&](const Desc& d, uint64_t) {
+                    if (d.seq != expect) errors[c]++;
+                    expect++;
+                });
+                if (k == 0) idle(spins);
+            }
+        });
+
+    const auto t0 = std::chrono::steady_clock::now();
+    uint32_t spins = 0;
+    for (uint64_t s = 0; s < total;) {
+        const uint64_t left = total - s;
+        uint64_t first;
+        const uint32_t got = ring->try_claim(left < BATCH ? (uint32_t)left : BATCH, first);
+        if (got == 0) { idle(spins); continue; }
+        for (uint32_t i = 0; i < got; ++i) {
+            const uint64_t q = first + i;
+            ring->slot(q) = Desc{ q, (uint32_t)(q * 64), 64 };
+        }
+        ring->publish(got);
+        s += got;
+    }
+    for (auto& t : consumers) t.join();
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    for (uint32_t c = 0; c < n; ++c)
+        if (errors[c]) std::cout << "[BROADCAST] consumidor " << c << " fora de ordem: " << errors[c] << "\n";
+    return total / secs / 1e6;
+}
+
+int main(int argc, char** argv) {
+    uint32_t n = (argc > 1) ? (uint32_t)std::atoi(argv[1]) : 3;
+    const uint64_t total = (argc > 2) ? (uint64_t)std::atoll(argv[2]) * 1000000ULL : 10000000ULL;
+    if (n == 0 || n > MAX_CONSUMERS) n = 3;
+
+    std::cout << "[BROADCAST] " << n << " consumidores | " << total << " descritores\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "fanout    : " << run_fanout(n, total)    << " M desc/s\n";
+    std::cout << "broadcast : " << run_broadcast(n, total) << " M desc/s\n";
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// bench_event_count.cpp - Busy-Poll vs EventCount no Consumidor
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Mede as tres coisas que decidem entre girar e estacionar o
+// consumidor de uma NetworkQueue:
+//
+//   1. CPU ocioso   : consumidor esperando por Q ms sem trafego;
+//                     tempo de CPU da thread (CLOCK_THREAD_CPUTIME_ID)
+//                     sobre o tempo de parede.
+//   2. Wakeup       : produtor esparso (um item a cada G us); o
+//                     item leva o instante do enqueue e o consumidor
+//                     registra agora - instante. P50/P99/max.
+//   3. Produtor     : ns por enqueue com e sem notify(), ninguem
+//                     estacionado (o caso quente sob carga).
+//
+// busy-poll: pop() + pause em loop (o que a logica fazia antes).
+// eventcount: EventCount::await com orcamento de spins e futex.
+//
+// Uso: bench_event_count [quieto_ms] [itens esparsos] [intervalo_us]
+// ================================================================
+
+#include "core/sys/event_count.hpp"
+#include "core/sys/network_queue.hpp"
+#include "core/sys/latency_histogram.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <sched.h>
+
+using namespace petronilho;
+
+static constexpr size_t   QUEUE_CAP = 1024;
+static constexpr uint32_t SPINS     = 2048;
+
+typedef net::NetworkQueue<uint64_t, QUEUE_CAP> Queue;
+
+static uint64_t now_ns() noexcept {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t thread_cpu_ns() noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static const uint64_t STOP = ~0ULL;
+
+struct Consumer {
+    Queue&                q;
+    sys::EventCount&      ec;
+    bool                  park;
+    sys::LatencyHistogram hist;
+    uint64_t              cpu_ns = 0;
+
+    Consumer(Queue& queue, sys::EventCount& e, bool parks) noexcept
+        : q(queue), ec(e), park(parks) {}
+
+    void operator()() noexcept {
+        const uint64_t cpu0 = thread_cpu_ns();
+        uint64_t v;
+        for (;;) {
+            if (!q.dequeue(v)) {
+                if (park) (void)ec.await([&] { return !q.empty(); }, SPINS);
+                else      _mm_pause();
+                continue;
+            }
+            if (v == STOP) break;
+            if (v) hist.record(now_ns() - v);
+        }
+        cpu_ns = thread_cpu_ns() - cpu0;
+    }
+};
+
+static void push(Queue& q, sys::EventCount& ec, uint64_t v) noexcept {
+    while (!q.enqueue(v)) sched_yield();
+    ec.notify();
+}
+
+// 1. CPU do consumidor sem trafego por quiet_ms
+static double idle_cpu(bool park, uint32_t quiet_ms) {
+    Queue q;
+    sys::EventCount ec;
+    Consumer c(q, ec, park);
+    const uint64_t t0 = now_ns();
+    std::thread th(std::ref(c));
+    std::this_thread::sleep_for(std::chrono::milliseconds(quiet_ms));
+    push(q, ec, STOP);
+    th.join();
+    return 100.0 * (double)c.cpu_ns / (double)(now_ns() - t0);
+}
+
+// 2. Latencia enqueue -> consumidor com itens esparsos
+static void wakeup(bool park, uint32_t items, uint32_t gap_us, sys::LatencyHistogram& out,
+                   uint64_t& parks) {
+    Queue q;
+    sys::EventCount ec;
+    Consumer c(q, ec, park);
+    std::thread th(std::ref(c));
+    for (uint32_t i = 0; i < items; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+        push(q, ec, now_ns());
+    }
+    push(q, ec, STOP);
+    th.join();
+    out   = c.hist;
+    parks = ec.parks();
+}
+
+// 3. Custo do produtor: enqueue (+ notify) e dequeue na mesma
+// thread, fila nunca cheia, ninguem estacionado
+static double producer_ns(bool notify, uint64_t ops) {
+    Queue q;
+    sys::EventCount ec;
+    uint64_t v;
+    volatile uint64_t sum = 0;
+    const uint64_t t0 = now_ns();
+    for (uint64_t i = 1; i <= ops; ++i) {
+        (void)q.enqueue(i);
+        if (notify) ec.notify();
+        if (q.dequeue(v)) sum = sum + v;
+    }
+    const uint64_t dt = now_ns() - t0;
+    return (double)dt / (double)ops;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t quiet_ms = (argc > 1) ? (uint32_t)std::atoi(argv[1]) : 1000;
+    const uint32_t items    = (argc > 2) ? (uint32_t)std::atoi(argv[2]) : 2000;
+    const uint32_t gap_us   = (argc > 3) ? (uint32_t)std::atoi(argv[3]) : 500;
+
+    {
+        sys::EventCount probe;
+        std::cout << "[EVENTCOUNT] fila " << QUEUE_CAP << " | spins " << SPINS << " | barreira "
+                  << (probe.asymmetric() ? "assimetrica (membarrier)" : "simetrica (mfence)")
+                  << " | " << std::thread::hardware_concurrency() << " CPUs\n";
+    }
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::cout << "\n  1. CPU ocioso (" << quiet_ms << " ms sem trafego)\n";
+    std::cout << "     busy-poll  : " << std::setw(6) << idle_cpu(false, quiet_ms) << " %\n";
+    std::cout << "     eventcount : " << std::setw(6) << idle_cpu(true, quiet_ms)  << " %\n";
+
+    std::cout << "\n  2. Wakeup (" << items << " itens, 1 a cada " << gap_us << " us), ns\n";
+    std::cout << "     modo       |      P50 |      P99 |    P99.9 |      max | estacionou\n";
+    for (int park = 0; park < 2; ++park) {
+        sys::LatencyHistogram h;
+        uint64_t parks = 0;
+        wakeup(park != 0, items, gap_us, h, parks);
+        std::cout << "     " << (park ? "eventcount" : "busy-poll ") << " | "
+                  << std::setw(8) << h.percentile(50.0) << " | "
+                  << std::setw(8) << h.percentile(99.0) << " | "
+                  << std::setw(8) << h.percentile(99.9) << " | "
+                  << std::setw(8) << h.max() << " | " << parks << "\n";
+    }
+
+    const uint64_t ops = 20000000ULL;
+    const double base = producer_ns(false, ops);
+    const double with = producer_ns(true, ops);
+    std::cout << std::setprecision(2);
+    std::cout << "\n  3. Produtor (ninguem estacionado), ns por enqueue+dequeue\n";
+    std::cout << "     sem notify : " << std::setw(6) << base << "\n";
+    std::cout << "     com notify : " << std::setw(6) << with
+              << "  (+" << with - base << ")\n";
+    return 0;
+}
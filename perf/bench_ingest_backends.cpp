@@ -0,0 +1,171 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// bench_ingest_backends.cpp - Backends lado a lado no IngestEngine
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Roda o MESMO IngestEngine<Backend, QueueSink, SpinWait> com
+// cada backend de recepcao, contra o mesmo gerador de loopback,
+// e imprime uma linha por backend com os contadores do motor:
+//
+//   recv      : recvmsg, 1 datagrama por syscall
+//   recvmmsg  : lote de 32 por syscall
+//   af_packet : anel TPACKET_V3 (requer CAP_NET_RAW)
+//   io_uring  : multishot + buffer ring (so se houver liburing)
+//
+// Um consumidor separado esvazia a fila e devolve os descritores,
+// como a thread de logica de producao.
+//
+// LEITURA DOS RESULTADOS:
+// Gerador, motor e consumidor dividem a mesma maquina: compare
+// as linhas entre si, nao com numeros absolutos de outro host.
+//
+// Uso: bench_ingest_backends [segundos]
+// ================================================================
+
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/udp_socket.hpp"
+#if __has_include(<liburing.h>)
+#include "core/sys/ingest_backend_uring.hpp"
+#define PETRONILHO_BENCH_URING 1
+#endif
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+using namespace petronilho;
+
+static constexpr uint16_t PORT       = 9999;
+static constexpr size_t   ARENA_SIZE = 64ULL * 1024 * 1024;
+
+typedef net::QueueSink<16384> Sink;
+typedef net::SpinWait         Wait;
+
+static void sender(std::atomic<bool>* running) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in dst{};
+    dst.sin_family      = AF_INET;
+    dst.sin_port        = htons(PORT);
+    dst.sin_addr.s_addr = inet_addr("127.0.0.1");
+    connect(fd, (const sockaddr*)&dst, sizeof(dst));
+
+    char payload[64];
+    std::memset(payload, 'P', sizeof(payload));
+    while (running->load(std::memory_order_relaxed))
+        (void)send(fd, payload, sizeof(payload), 0);
+    close(fd);
+}
+
+static void consumer(Sink* sink, std::atomic<bool>* running) {
+    net::Datagram d;
+    for (;;) {
+        if (sink->pop(d)) { sink->done(d); continue; }
+        if (!running->load(std::memory_order_acquire)) break;
+        _mm_pause();
+    }
+}
+
+// ================================================================
+// run_backend - Mesmo motor, mesmo sink, mesma espera
+// ================================================================
+template<typename Backend>
+static void run_backend(Backend& backend, sys::ScalableArena& arena, int seconds) {
+    auto sink = std::make_unique<Sink>(arena);
+    Wait wait;
+    net::IngestEngine<Backend, Sink, Wait> engine(backend, *sink, wait);
+    (void)engine.attach();
+
+    std::atomic<bool> consuming{true}, sending{true};
+    std::thread cons(consumer, sink.get(), &consuming);
+    std::thread tx(sender, &sending);
+
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    engine.run([&] { return std::chrono::steady_clock::now() < end; });
+
+    sending = false;
+    tx.join();
+    consuming.store(false, std::memory_order_release);
+    cons.join();
+
+    const auto& st = engine.stats();
+    const auto& h  = wait.histogram();
+    std::cout << std::setw(9) << Backend::NAME << " | "
+              << std::setw(8) << std::fixed << std::setprecision(3)
+              << st.packets / 1e6 / seconds << " | "
+              << std::setw(8) << std::setprecision(2) << st.packets_per_poll() << " | "
+              << std::setw(10) << h.percentile(50) << " | "
+              << std::setw(10) << h.percentile(99) << " | "
+              << std::setw(8) << st.dropped << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const int seconds = (argc > 1) ? std::atoi(argv[1]) : 3;
+
+    void* arena_mem = nullptr;
+    if (posix_memalign(&arena_mem, 4096, ARENA_SIZE) != 0) return 1;
+    sys::ScalableArena arena(arena_mem, ARENA_SIZE);
+
+    net::UdpSocketConfig cfg;
+    cfg.port         = PORT;
+    cfg.rcvbuf_bytes = 16 * 1024 * 1024;
+
+    std::cout << "[BACKENDS] IngestEngine<Backend, queue, spin> | "
+              << seconds << "s por backend\n";
+    std::cout << "  backend |     Mpps | pkt/poll |   P50 (ns) |   P99 (ns) |  drops\n";
+
+    {
+        const int fd = net::open_udp_socket(cfg);
+        (void)net::enable_rx_timestamps(fd);
+        net::RecvBackend backend(fd, 2048);
+        run_backend(backend, arena, seconds);
+        close(fd);
+        arena.reset();
+    }
+    {
+        const int fd = net::open_udp_socket(cfg);
+        (void)net::enable_rx_timestamps(fd);
+        net::RecvmmsgBackend<32> backend(fd, 32, 2048);
+        run_backend(backend, arena, seconds);
+        close(fd);
+        arena.reset();
+    }
+    {
+        // Socket so para a porta existir (sem ICMP); nunca e lido
+        net::UdpSocketConfig sink_cfg = cfg;
+        sink_cfg.rcvbuf_bytes = 4096;
+        const int fd = net::open_udp_socket(sink_cfg);
+        auto ring = std::make_unique<net::PacketRing>();
+        net::PacketRingConfig pcfg;
+        pcfg.udp_port = PORT;
+        if (ring->open(pcfg)) {
+            net::PacketRingBackend backend(*ring);
+            run_backend(backend, arena, seconds);
+        } else {
+            perror("af_packet");
+        }
+        close(fd);
+        arena.reset();
+    }
+#ifdef PETRONILHO_BENCH_URING
+    {
+        const int fd = net::open_udp_socket(cfg);
+        auto backend = std::make_unique<net::UringBackend<4096>>(fd);
+        if (backend->init(arena, 2048)) run_backend(*backend, arena, seconds);
+        else perror("io_uring");
+        close(fd);
+        arena.reset();
+    }
+#endif
+
+    free(arena_mem);
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// bench_mpsc_queue.cpp - Contencao MPSC de 1 a N Produtores
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Para P = 1, 2, ..., N produtores, cada um empurra M elementos
+// {produtor, seq} para um unico consumidor, que drena em lotes de
+// 64 e confere a ordem FIFO de cada produtor. Duas filas:
+//
+//   spinlock : NetworkQueue (SPSC) protegida por um spinlock, o
+//              que se faria sem fila MPSC
+//   mpsc     : MpscQueue (um fetch_add por enqueue, sem lock)
+//
+// Imprime Mops/s no consumidor e enqueues recusados (fila cheia).
+// Os produtores sao fixados nos nucleos 1..P e o consumidor no 0
+// quando ha nucleos suficientes; senao cedem a CPU quando a fila
+// enche.
+//
+// Uso: bench_mpsc_queue [max_produtores] [elementos por produtor]
+// ================================================================
+
+#include "core/sys/mpsc_queue.hpp"
+#include "core/sys/network_queue.hpp"
+#include "core/platform/platform_detect.hpp"
+#include "core/platform/memory_util.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <sched.h>
+
+using namespace petronilho;
+
+static constexpr size_t   QUEUE_CAP = 4096;
+static constexpr size_t   BATCH     = 64;
+static constexpr uint32_t MAX_PROD  = 64;
+
+struct Item {
+    uint32_t producer;
+    uint32_t _pad;
+    uint64_t seq;
+};
+
+// Baseline: SPSC + spinlock no lado dos produtores
+class LockedQueue {
+private:
+    alignas(64) std::atomic_flag             m_lock = ATOMIC_FLAG_INIT;
+    net::NetworkQueue<Item, QUEUE_CAP>       m_queue;
+
+public:
+    bool enqueue(const Item& v) noexcept {
+        while (m_lock.test_and_set(std::memory_order_acquire)) _mm_pause();
+        const bool ok = m_queue.enqueue(v);
+        m_lock.clear(std::memory_order_release);
+        return ok;
+    }
+
+    size_t dequeue_batch(Item* out, size_t max) noexcept {
+        size_t n = 0;
+        while (n < max && m_queue.dequeue(out[n])) ++n;
+        return n;
+    }
+};
+
+struct Result {
+    double   mops;
+    uint64_t rejected;
+    uint64_t order_errors;
+};
+
+static bool g_pin = false;
+
+template<typename Queue>
+static Result run(Queue& q, uint32_t producers, uint64_t per_producer) {
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<bool>     go{false};
+    std::vector<std::thread> threads;
+
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            if (g_pin) (void)platform::cpu_affinity_portable((int)(1 + p));
+            while (!go.load(std::memory_order_acquire)) _mm_pause();
+            uint64_t local_rejected = 0;
+            uint32_t spins = 0;
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                const Item it{ p, 0, i };
+                while (!q.enqueue(it)) {
+                    ++local_rejected;
+                    _mm_pause();
+                    if ((++spins & 255) == 0) sched_yield();
+                }
+            }
+            rejected.fetch_add(local_rejected, std::memory_order_relaxed);
+        });
+    }
+
+    if (g_pin) (void)platform::cpu_affinity_portable(0);
+    std::vector<uint64_t> next(producers, 0);
+    uint64_t errors = 0;
+    const uint64_t total = per_producer * producers;
+    Item out[BATCH];
+
+    const auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    uint32_t idle = 0;
+    for (uint64_t got = 0; got < total;) {
+        const size_t n = q.dequeue_batch(out, BATCH);
+        if (n == 0) {
+            _mm_pause();
+            if ((++idle & 255) == 0) sched_yield();
+            continue;
+        }
+        for (size_t k = 0; k < n; ++k) {
+            if (out[k].seq != next[out[k].producer]) ++errors;
+            next[out[k].producer] = out[k].seq + 1;
+        }
+        got += n;
+    }
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    for (auto& t : threads) t.join();
+
+    return Result{ (double)total * 1e3 / ns, rejected.load(), errors };
+}
+
+int main(int argc, char** argv) {
+    const uint32_t hw = std::thread::hardware_concurrency();
+    uint32_t max_prod = (argc > 1) ? (uint32_t)std::atoi(argv[1]) : (hw > 1 ? hw - 1 : 4);
+    if (max_prod > MAX_PROD) max_prod = MAX_PROD;
+    const uint64_t per = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 2000000ULL;
+    g_pin = hw > max_prod;
+
+    std::cout << "[MPSC] fila " << QUEUE_CAP << " | " << per << " por produtor | lote "
+              << BATCH << " | " << (g_pin ? "threads fixadas" : "sem afinidade (yield)") << "\n";
+    std::cout << "  prod |  spinlock Mops/s  recusas |      mpsc Mops/s  recusas | ganho\n";
+    std::cout << std::fixed;
+
+    uint64_t errors = 0;
+    for (uint32_t p = 1; p <= max_prod; ++p) {
+        auto locked = std::make_unique<LockedQueue>();
+        auto mpsc   = std::make_unique<net::MpscQueue<Item, QUEUE_CAP>>();
+        const Result a = run(*locked, p, per);
+        const Result b = run(*mpsc, p, per);
+        errors += a.order_errors + b.order_errors;
+        std::cout << "  " << std::setw(4) << p << " | "
+                  << std::setprecision(2) << std::setw(16) << a.mops << " " << std::setw(8) << a.rejected << " | "
+                  << std::setw(16) << b.mops << " " << std::setw(8) << b.rejected << " | "
+                  << std::setw(4) << b.mops / a.mops << "x\n";
+    }
+    std::cout << "  fora de ordem (por produtor): " << errors << "\n";
+    return errors ? 1 : 0;
+}
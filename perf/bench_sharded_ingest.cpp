@@ -0,0 +1,126 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// bench_sharded_ingest.cpp - Escalabilidade do Ingest SO_REUSEPORT
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Sobe o ShardedIngest com 1, 2, ..., N shards e, para cada N,
+// inunda a porta pelo loopback com 2N fluxos (sockets de origem
+// distintos, para o hash do REUSEPORT espalhar). Mede pacotes/s
+// recebidos no total e por shard.
+//
+// LEITURA DOS RESULTADOS:
+// Os geradores rodam na mesma maquina e disputam CPU com os
+// shards. Para medir o ingestor isolado, rode o gerador em outra
+// maquina e use este programa com 'senders=0'.
+//
+// Uso: bench_sharded_ingest [max_shards] [segundos] [senders=1|0]
+// ================================================================
+
+#include "core/sys/sharded_ingest.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <arpa/inet.h>
+
+static constexpr uint16_t PORT = 9999;
+static constexpr uint32_t MAX_SHARDS = 64;
+
+static petronilho::net::ShardedIngest<MAX_SHARDS> g_engine;
+
+static void sender(std::atomic<bool>* running, uint64_t* sent) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in dst{};
+    dst.sin_family      = AF_INET;
+    dst.sin_port        = htons(PORT);
+    dst.sin_addr.s_addr = inet_addr("127.0.0.1");
+    connect(fd, (const sockaddr*)&dst, sizeof(dst));
+
+    char payload[64];
+    std::memset(payload, 'P', sizeof(payload));
+    uint64_t n = 0;
+    while (running->load(std::memory_order_relaxed))
+        if (send(fd, payload, sizeof(payload), 0) > 0) n++;
+    *sent = n;
+    close(fd);
+}
+
+static void consumer(uint32_t shard, std::atomic<bool>* running, uint64_t* consumed) {
+    petronilho::net::ShardPacket pkt;
+    uint64_t n = 0;
+    while (running->load(std::memory_order_relaxed)) {
+        if (g_engine.poll(shard, pkt)) n++;
+        else _mm_pause();
+    }
+    while (g_engine.poll(shard, pkt)) n++;
+    *consumed = n;
+}
+
+int main(int argc, char** argv) {
+    const long ncpu        = sysconf(_SC_NPROCESSORS_ONLN);
+    const uint32_t max_n   = (argc > 1) ? (uint32_t)std::atoi(argv[1]) : (uint32_t)ncpu;
+    const int seconds      = (argc > 2) ? std::atoi(argv[2]) : 3;
+    const bool run_senders = (argc > 3) ? std::atoi(argv[3]) != 0 : true;
+
+    const size_t ARENA_SIZE = 64ULL * 1024 * 1024 * (max_n < 8 ? max_n : 8);
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, 4096, ARENA_SIZE) != 0) return 1;
+    std::memset(buffer, 0, ARENA_SIZE);
+
+    std::cout << "[SHARDED] CPUs online: " << ncpu
+              << " | Shards: 1.." << max_n << " | " << seconds << "s por ponto\n";
+    std::cout << "shards |   Mpps rx | pkt/syscall | fila cheia | por shard (Kpps)\n";
+
+    for (uint32_t n = 1; n <= max_n && n <= MAX_SHARDS; ++n) {
+        if (!g_engine.start(n, PORT, buffer, ARENA_SIZE, 0)) {
+            perror("[SHARDED] start");
+            return 1;
+        }
+
+        std::atomic<bool> consuming{true}, sending{true};
+        std::vector<uint64_t> consumed(n, 0), sent(2 * n, 0);
+        std::vector<std::thread> consumers, senders;
+        for (uint32_t i = 0; i < n; ++i)
+            consumers.emplace_back(consumer, i, &consuming, &consumed[i]);
+        if (run_senders)
+            for (uint32_t i = 0; i < 2 * n; ++i)
+                senders.emplace_back(sender, &sending, &sent[i]);
+
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+        uint64_t packets = 0, syscalls = 0, full = 0;
+        std::vector<uint64_t> per_shard(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            const auto& c = g_engine.counters(i);
+            per_shard[i] = c.packets.load(std::memory_order_relaxed);
+            packets  += per_shard[i];
+            syscalls += c.syscalls.load(std::memory_order_relaxed);
+            full     += c.queue_full.load(std::memory_order_relaxed);
+        }
+
+        sending = false;
+        for (auto& t : senders) t.join();
+        consuming = false;
+        for (auto& t : consumers) t.join();
+        g_engine.stop();
+
+        std::cout << std::setw(6) << n << " | "
+                  << std::setw(9) << std::fixed << std::setprecision(3)
+                  << packets / 1e6 / seconds << " | "
+                  << std::setw(11) << std::setprecision(2)
+                  << (syscalls ? (double)packets / syscalls : 0.0) << " | "
+                  << std::setw(10) << full << " |";
+        for (uint32_t i = 0; i < n; ++i)
+            std::cout << " " << std::setprecision(0) << per_shard[i] / 1e3 / seconds;
+        std::cout << std::endl;
+    }
+
+    free(buffer);
+    return 0;
+}
@@ -0,0 +1,307 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// e2e_latency.cpp - Latencia Ponta a Ponta em Loopback
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Liga o net_stress_gen (processo filho) ao pipeline de producao
+// e mede a latencia de UMA via, do envio ate cada estagio:
+//
+//   recv      : datagrama entregue pelo IngestEngine ao sink
+//   enqueue   : descritor publicado na NetworkQueue
+//   dequeue   : descritor retirado pela thread de logica
+//   persisted : registro gravado no journal (PersistentArena)
+//
+// Cada estagio le o TSC e subtrai o carimbo do ProbeHeader. Como
+// gerador e ingestor rodam na mesma maquina, o TSC invariante e
+// um relogio comum; tsc_per_ns() converte ciclos em ns.
+//
+// COORDINATED OMISSION:
+// Se o gerador atrasa (fila cheia, preempcao), o pacote sai tarde
+// e send_tsc esconde a espera. O agendador grava intended_tsc, o
+// instante em que o pacote DEVIA sair; a curva "corrigida" mede a
+// partir dele, a "bruta" a partir de send_tsc. Uma distancia
+// grande entre as duas indica gerador saturado.
+//
+// PERDA: lacunas na seq de cada stream (SequenceTracker).
+//
+// Uma rodada por taxa oferecida: o filho roda --seconds e sai; o
+// pipeline esvazia, as threads terminam e os histogramas (um
+// escritor cada) sao lidos sem corrida.
+//
+// ALGORITMO: Histograma Log-Linear por Estagio
+// BASE TEORICA: Cormen Cap.8 Sec.8.2 - Counting Sort
+//               Cormen Cap.9 - Order Statistics
+// Cada percentil e a estatistica de ordem da soma acumulada dos
+// baldes (latency_histogram.hpp), sem guardar amostras.
+//
+// Uso: e2e_latency [--gen ./net_stress_gen] [--rates 50000,100000]
+//                  [--seconds S] [--threads N] [--size ...]
+// ================================================================
+
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/udp_socket.hpp"
+#include "core/sys/probe_header.hpp"
+#include "core/sys/latency_histogram.hpp"
+#include "core/sys/persistent_arena.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace petronilho;
+
+static constexpr uint16_t PORT         = 9999;
+static constexpr size_t   ARENA_SIZE   = 64ULL * 1024 * 1024;
+static constexpr size_t   JOURNAL_SIZE = 256ULL * 1024 * 1024;
+static constexpr uint32_t MAX_STREAMS  = 64;
+
+enum Stage : uint32_t { RECV, ENQUEUE, DEQUEUE, PERSISTED, STAGES };
+static const char* STAGE_NAMES[STAGES] = { "recv", "enqueue", "dequeue", "persisted" };
+
+// Par de curvas por estagio: a partir do envio real e do agendado
+struct StageHist {
+    sys::LatencyHistogram raw;
+    sys::LatencyHistogram corrected;
+
+    PETRONILHO_FORCE_INLINE void record(const net::ProbeHeader& h,
+                                        uint64_t now, double tpn) noexcept {
+        raw.record(now > h.send_tsc ? (uint64_t)((now - h.send_tsc) / tpn) : 0);
+        corrected.record(now > h.intended_tsc ? (uint64_t)((now - h.intended_tsc) / tpn) : 0);
+    }
+};
+
+struct RunResult {
+    StageHist stages[STAGES];
+    net::SequenceTracker<MAX_STREAMS> seq;
+    uint64_t  not_probe = 0;
+};
+
+// ================================================================
+// ProbeSink - QueueSink que carimba recv e enqueue
+// O resto do contrato (slot, drain_returns, pop, done) e repassado.
+// ================================================================
+template<size_t Capacity>
+class ProbeSink {
+private:
+    net::QueueSink<Capacity> m_queue;
+    RunResult&               m_result;
+    double                   m_tpn;
+
+public:
+    static constexpr const char* NAME  = "probe-queue";
+    static constexpr bool        HOLDS = true;
+
+    ProbeSink(sys::ScalableArena& arena, RunResult& result, double tpn) noexcept
+        : m_queue(arena), m_result(result), m_tpn(tpn) {}
+
+    [[nodiscard]]
+    void* slot(uint32_t cap) noexcept { return m_queue.slot(cap); }
+
+    bool publish(const net::Datagram& d) noexcept {
+        net::ProbeHeader h;
+        if (!net::read_probe(d.data, d.len, h)) {
+            ++m_result.not_probe;
+            return m_queue.publish(d);
+        }
+        m_result.stages[RECV].record(h, sys::read_tsc(), m_tpn);
+        m_result.seq.observe(h.stream, h.seq);
+
+        const bool ok = m_queue.publish(d);
+        if (ok) m_result.stages[ENQUEUE].record(h, sys::read_tsc(), m_tpn);
+        return ok;
+    }
+
+    template<typename OnReturn>
+    void drain_returns(OnReturn&& on_return) noexcept {
+        m_queue.drain_returns(on_return);
+    }
+
+    [[nodiscard]]
+    bool pop(net::Datagram& d) noexcept { return m_queue.pop(d); }
+
+    void done(const net::Datagram& d) noexcept { m_queue.done(d); }
+};
+
+typedef ProbeSink<16384> Sink;
+typedef net::AdaptiveWait Wait;
+
+// Thread de logica: dequeue -> journal -> done
+static void logic_thread(Sink* sink, PersistentArena* journal_mem, RunResult* r,
+                         double tpn, std::atomic<bool>* running) {
+    net::PersistentSink journal(*journal_mem);
+    net::Datagram d;
+    for (;;) {
+        if (!sink->pop(d)) {
+            if (!running->load(std::memory_order_acquire)) break;
+            _mm_pause();
+            continue;
+        }
+        net::ProbeHeader h;
+        const bool probe = net::read_probe(d.data, d.len, h);
+        if (probe) r->stages[DEQUEUE].record(h, sys::read_tsc(), tpn);
+
+        // Copia para o journal: o slot da fila volta ao motor
+        net::Datagram copy = d;
+        copy.in_place = 0;
+        if (journal.publish(copy) && probe)
+            r->stages[PERSISTED].record(h, sys::read_tsc(), tpn);
+        sink->done(d);
+    }
+}
+
+static pid_t spawn_generator(const std::string& gen, uint64_t rate, uint32_t seconds,
+                             uint32_t threads, const std::string& size) {
+    const std::string r = std::to_string(rate);
+    const std::string s = std::to_string(seconds);
+    const std::string t = std::to_string(threads);
+    const char* argv[] = {
+        gen.c_str(), "--rate", r.c_str(), "--seconds", s.c_str(),
+        "--threads", t.c_str(), "--size", size.c_str(), nullptr
+    };
+
+    // Relatorio do gerador vai para /dev/null: a saida e a tabela
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addopen(&fa, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    pid_t pid = -1;
+    if (posix_spawn(&pid, gen.c_str(), &fa, nullptr,
+                    const_cast<char**>(argv), environ) != 0)
+        pid = -1;
+    posix_spawn_file_actions_destroy(&fa);
+    return pid;
+}
+
+static void print_curve(const char* label, const RunResult& r, bool corrected) {
+    static const double PCTS[] = { 50, 90, 99, 99.9, 99.99 };
+    std::cout << "  " << label << "\n"
+              << "    estagio   |     p50 |     p90 |     p99 |   p99.9 |  p99.99 |     max  (us)\n";
+    for (uint32_t s = 0; s < STAGES; ++s) {
+        const auto& h = corrected ? r.stages[s].corrected : r.stages[s].raw;
+        std::cout << "    " << std::left << std::setw(9) << STAGE_NAMES[s] << std::right;
+        for (double p : PCTS)
+            std::cout << " | " << std::setw(7) << h.percentile(p) / 1000.0;
+        std::cout << " | " << std::setw(8) << h.max() / 1000.0 << "\n";
+    }
+}
+
+// ================================================================
+// run_rate - Uma rodada: pipeline novo, gerador filho, relatorio
+// ================================================================
+static bool run_rate(int fd, sys::ScalableArena& arena, PersistentArena& journal,
+                     const std::string& gen, uint64_t rate, uint32_t seconds,
+                     uint32_t threads, const std::string& size, double tpn) {
+    auto result = std::make_unique<RunResult>();
+    auto sink   = std::make_unique<Sink>(arena, *result, tpn);
+    net::RecvmmsgBackend<32> backend(fd, 32, 2048);
+    Wait wait;
+    net::IngestEngine<net::RecvmmsgBackend<32>, Sink, Wait> engine(backend, *sink, wait);
+    (void)engine.attach();
+
+    std::atomic<bool> ingesting{true}, consuming{true};
+    std::thread ingest([&] { engine.run([&] { return ingesting.load(std::memory_order_relaxed); }); });
+    std::thread logic(logic_thread, sink.get(), &journal, result.get(), tpn, &consuming);
+
+    const pid_t pid = spawn_generator(gen, rate, seconds, threads, size);
+    if (pid > 0) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+    } else {
+        std::cerr << "[E2E] nao foi possivel executar " << gen << std::endl;
+    }
+
+    // Esvazia o socket e a fila antes de ler os histogramas
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ingesting = false;
+    ingest.join();
+    consuming.store(false, std::memory_order_release);
+    logic.join();
+    if (pid <= 0) return false;
+
+    const auto& seq = result->seq;
+    std::cout << "[E2E] taxa oferecida " << rate << " pps | recebidos " << seq.received()
+              << " | perdidos " << seq.lost()
+              << " (" << std::setprecision(3) << seq.loss_ratio() * 100.0 << "%)"
+              << " | tardios " << seq.late()
+              << " | descartes na fila " << engine.stats().dropped << "\n";
+    std::cout << std::setprecision(1);
+    print_curve("corrigida (desde intended_tsc)", *result, true);
+    print_curve("bruta (desde send_tsc)", *result, false);
+    std::cout << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string gen  = "./net_stress_gen";
+    std::string size = "64";
+    std::vector<uint64_t> rates = { 50000, 100000, 200000 };
+    uint32_t seconds = 3;
+    uint32_t threads = 1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string k = argv[i];
+        const char*       v = argv[i + 1];
+        if (k == "--gen")          gen = v;
+        else if (k == "--size")    size = v;
+        else if (k == "--seconds") seconds = (uint32_t)std::atoi(v);
+        else if (k == "--threads") threads = (uint32_t)std::atoi(v);
+        else if (k == "--rates") {
+            rates.clear();
+            for (const char* p = v; *p;) {
+                rates.push_back(std::strtoull(p, const_cast<char**>(&p), 10));
+                if (*p == ',') ++p;
+                else if (*p) break;
+            }
+        } else {
+            std::cerr << "Uso: e2e_latency [--gen ./net_stress_gen] [--rates R1,R2,...]"
+                         " [--seconds S] [--threads N] [--size ...]" << std::endl;
+            return 1;
+        }
+    }
+    if (threads == 0 || threads > MAX_STREAMS) threads = 1;
+
+    const double tpn = sys::tsc_per_ns();
+
+    void* arena_mem = nullptr;
+    if (posix_memalign(&arena_mem, 4096, ARENA_SIZE) != 0) return 1;
+    sys::ScalableArena arena(arena_mem, ARENA_SIZE);
+    PersistentArena journal("e2e_journal.log", JOURNAL_SIZE);
+
+    net::UdpSocketConfig cfg;
+    cfg.port         = PORT;
+    cfg.rcvbuf_bytes = 16 * 1024 * 1024;
+    const int fd = net::open_udp_socket(cfg);
+    if (fd < 0) { perror("socket"); return 1; }
+
+    std::cout << "[E2E] " << gen << " -> :" << PORT
+              << " | " << threads << " stream(s) | " << seconds << "s por taxa"
+              << " | payload " << size
+              << " | TSC " << std::fixed << std::setprecision(3) << tpn << " ciclos/ns\n\n";
+
+    for (uint64_t rate : rates) {
+        if (!run_rate(fd, arena, journal, gen, rate, seconds, threads, size, tpn)) break;
+        arena.reset();
+        journal.reset();
+    }
+
+    close(fd);
+    free(arena_mem);
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <atomic>
 #include <pthread.h>
 #include <liburing.h>
 #include <sys/socket.h>
@@ -6,92 +7,96 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <cstring>
-#include "core/sys/arena_atomic.hpp"
-#include "core/sys/network_queue.hpp"
-#include "core/sys/telemetry.hpp"
+#include <cstdio>
+#include "core/sys/arena.hpp"
+#include "core/sys/udp_socket.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backend_uring.hpp"
+#include "core/sys/ingest_sinks.hpp"
+#include "core/sys/backpressure.hpp"
 
-using namespace super_core;
+using namespace petronilho;
 
-struct NetPacket { 
-    uint32_t id; 
-    uint64_t timestamp_entry;
-    char payload[64]; 
-};
+static constexpr uint32_t RING_ENTRIES = 4096;
+static constexpr uint32_t BUF_SIZE     = 2048;
+
+// IngestEngine<io_uring, queue, blocking>: o payload fica no buffer
+// ring (memoria da Arena) e a logica le direto pelo descritor.
+// Nunca ha mais que RING_ENTRIES buffers em voo, entao a fila
+// nunca enche e o caminho de recepcao nao descarta. Se a logica
+// travar mesmo assim, BlockWithTimeout espera no maximo 200us por
+// datagrama em vez de parar a recepcao indefinidamente.
+typedef net::UringBackend<RING_ENTRIES>                  Backend;
+typedef net::QueueSink<16384, net::BlockWithTimeout>     Sink;
+typedef net::BlockingWait               Wait;
+static_assert(RING_ENTRIES < 16384, "filas devem comportar todos os buffers");
 
-typedef net::NetworkQueue<NetPacket, 16384> PacketQueue;
 static uint8_t g_arena_mem[64 * 1024 * 1024] __attribute__((aligned(4096)));
-static PacketQueue g_queue;
 static sys::ScalableArena g_arena(g_arena_mem, sizeof(g_arena_mem));
-static bool g_running = true;
+static Sink g_sink(g_arena, net::BlockWithTimeout(200000));
+static std::atomic<bool> g_running{true};
 
 void* network_uring_persistence_thread(void* arg) {
-    struct io_uring ring;
-    io_uring_queue_init(2048, &ring, 0);
-
-    // Socket Setup
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    sockaddr_in servaddr{};
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_addr.s_addr = INADDR_ANY;
-    servaddr.sin_port = htons(9999);
-    bind(sockfd, (const struct sockaddr *)&servaddr, sizeof(servaddr));
+    int sockfd = net::open_udp_socket({ .port = 9999, .non_blocking = false });
+    static Backend backend(sockfd);
+    if (sockfd < 0 || !backend.init(g_arena, BUF_SIZE)) {
+        perror("[SYSTEM] io_uring/socket setup");
+        g_running = false;
+        return nullptr;
+    }
 
-    // Disk Setup (Log File)
-    int log_fd = open("petronilho_network.log", O_WRONLY | O_CREAT | O_APPEND | O_DIRECT, 0644);
+    // Disk Setup (Log File): cada buffer tambem vira escrita
+    // io_uring; so volta ao anel apos escrita E consumo da logica.
+    int log_fd = open("petronilho_network.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log_fd >= 0) backend.set_journal(log_fd);
 
-    std::cout << "[SYSTEM] Ingest + Persistencia Async Ativa (io_uring)..." << std::endl;
+    // Espera curta: permite observar g_running
+    net::WaitConfig cfg;
+    cfg.block_timeout_ms = 1;
+    Wait wait(cfg);
+    net::IngestEngine<Backend, Sink, Wait> engine(backend, g_sink, wait);
+    (void)engine.attach();
 
-    while (g_running) {
-        auto h = g_arena.allocate<NetPacket>();
-        if (h.index != 0xFFFFFFFF) {
-            NetPacket* p = reinterpret_cast<NetPacket*>(g_arena_mem + h.index);
-            
-            // 1. Receber da Rede
-            struct io_uring_sqe *sqe_net = io_uring_get_sqe(&ring);
-            struct iovec iov_net = { .iov_base = p->payload, .iov_len = 64 };
-            struct msghdr msg = { .msg_iov = &iov_net, .msg_iovlen = 1 };
-            io_uring_prep_recvmsg(sqe_net, sockfd, &msg, 0);
-            io_uring_sqe_set_data(sqe_net, (void*)0x1); // Tag para rede
+    std::cout << "[SYSTEM] Ingest + Persistencia Async Ativa (io_uring multishot)..." << std::endl;
 
-            io_uring_submit(&ring);
+    engine.run([] { return g_running.load(std::memory_order_relaxed); });
 
-            struct io_uring_cqe *cqe;
-            if (io_uring_wait_cqe(&ring, &cqe) == 0) {
-                if (cqe->res > 0) {
-                    p->timestamp_entry = sys::read_tsc();
-                    
-                    // 2. Agendar Escrita em Disco (Sem travar o CPU)
-                    struct io_uring_sqe *sqe_disk = io_uring_get_sqe(&ring);
-                    io_uring_prep_write(sqe_disk, log_fd, p->payload, 64, 0);
-                    io_uring_sqe_set_data(sqe_disk, (void*)0x2); // Tag para disco
-                    io_uring_submit(&ring);
+    const auto& rx = backend.receiver();
+    std::cout << "[SYSTEM] CQEs/colheita: " << rx.completions_per_reap()
+              << " | Rearmes: " << rx.rearms()
+              << " | Anel vazio (ENOBUFS): " << rx.no_buffer_events()
+              << " | Journal: " << backend.journal_bytes() << " bytes" << std::endl;
+    const auto& bp = g_sink.policy().counters();
+    std::cout << "[SYSTEM] Fila cheia: " << bp.waits << " esperas | "
+              << bp.timeouts << " timeouts | " << bp.blocked_ns / 1000 << "us parado" << std::endl;
 
-                    // 3. Despachar para Lógica
-                    while (!g_queue.enqueue(h.index)) { __builtin_ia32_pause(); }
-                }
-                io_uring_cqe_seen(&ring, cqe);
-            }
-        }
-    }
-    
-    close(log_fd);
-    io_uring_queue_exit(&ring);
+    // Logica pode estar dormindo em pop_wait
+    g_sink.wake();
+    if (log_fd >= 0) close(log_fd);
+    close(sockfd);
     return nullptr;
 }
 
+// Fila vazia: gira ~4096 pausas e depois dorme no futex do sink
+// (CPU ~0 sem trafego). Timeout de 10ms para observar g_running.
 void* logic_processor_thread(void* arg) {
     uint32_t processed = 0;
     while (g_running) {
-        uint32_t idx;
-        if (g_queue.dequeue(idx)) {
-            NetPacket* p = reinterpret_cast<NetPacket*>(g_arena_mem + idx);
+        net::Datagram d;
+        if (g_sink.pop_wait(d, 4096, 10000000)) {
             if (processed % 10000 == 0) {
-                std::cout << "[LOGIC] Processado & Persistido batch: " << processed << std::endl;
+                std::cout << "[LOGIC] Processado & Persistido batch: " << processed
+                          << " (" << d.len << " bytes, byte0=" << (int)d.data[0] << ")" << std::endl;
             }
             processed++;
+
+            // Consumido: o buffer pode voltar ao anel
+            g_sink.done(d);
         }
-        if (processed >= 100000) g_running = false; 
+        if (processed >= 100000) g_running = false;
     }
+    std::cout << "[LOGIC] Estacionamentos no futex: " << g_sink.parks() << std::endl;
     return nullptr;
 }
 
@@ -76,7 +76,8 @@ namespace petronilho::priority {
             : m_capacity(max_nodes)
             , m_size(0)
         {
-            auto h = arena.allocate<petronilho::sys::Handle<T>>(max_nodes);
+            auto h = arena.allocate<petronilho::sys::Handle<T>>(
+                max_nodes, petronilho::sys::ArenaTag::HEAP);
             m_data = h.get_ptr();
         }
 
@@ -58,7 +58,8 @@ namespace petronilho::relational {
                   size_t max_entries) noexcept
             : m_capacity(max_entries)
         {
-            auto h   = arena.allocate<HashEntry<K,V>>(max_entries);
+            auto h   = arena.allocate<HashEntry<K,V>>(
+                max_entries, petronilho::sys::ArenaTag::HASH);
             m_table  = h.get_ptr();
 
             // Inicializa todos os slots como vazios
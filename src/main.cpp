@@ -3,77 +3,247 @@
 #include <unistd.h>
 #include <sched.h>
 #include <fcntl.h>
-#include "ring_buffer.hpp"
+#include "core/sys/ring_buffer.hpp"
+#include "core/sys/udp_socket.hpp"
+#include "core/sys/rx_timestamp.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/arena.hpp"
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
+#include "core/sys/backpressure.hpp"
+#include "core/sys/persistent_arena.hpp"
+#include <sys/resource.h>
+#include <cstring>
 #include <iostream>
 #include <chrono>
 #include <fstream>
+#include <cstdlib>
+#include <cstdio>
+
+// Ate 64 datagramas por recvmmsg. N efetivo vem de argv[1].
+static constexpr uint32_t MAX_BATCH = 64;
+static constexpr int      RUN_SECONDS = 300;
+static constexpr uint32_t DGRAM_SIZE  = 1472;
+static constexpr size_t   SPILL_SIZE  = 256ULL * 1024 * 1024;
+
+typedef petronilho::net::RecvmmsgBackend<MAX_BATCH> Backend;
+
+// ================================================================
+// ingest_loop - IngestEngine<recvmmsg, ring, Wait> por RUN_SECONDS
+// Wait: SpinWait, BusyPollWait, BlockingWait ou AdaptiveWait
+// Sink: RingSink<Policy>, Policy de backpressure.hpp
+// ================================================================
+template<typename Wait, typename Sink>
+static petronilho::net::IngestStats ingest_loop(Backend& backend, Sink& sink, Wait& wait) {
+    petronilho::net::IngestEngine<Backend, Sink, Wait> engine(backend, sink, wait);
+    if (!engine.attach())
+        std::cout << "[AVISO] " << Wait::NAME
+                  << ": configuracao parcial (SO_BUSY_POLL requer CAP_NET_ADMIN?)" << std::endl;
+
+    const auto& st = engine.stats();
+    uint64_t next_report = 100000;
+    auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        auto now     = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start).count();
+        if (elapsed >= RUN_SECONDS) break;
+
+        engine.step();
+
+        if (st.packets >= next_report) {
+            next_report += 100000;
+            std::cout << "\r[MONITOR] " << elapsed << "s | Pacotes: " << st.packets
+                      << " | Buffer: " << sink.ring().size() << "/" << sink.ring().capacity()
+                      << " | Descartados: " << st.dropped
+                      << " | Pkt/syscall: " << st.packets_per_poll() << std::flush;
+        }
+    }
 
-int main() {
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(2, &cpuset);
-    sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
-    std::cout << "[LINUX] Afinidade: Core 2." << std::endl;
+    const auto& h = wait.histogram();
+    const auto& c = wait.counters();
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    const double cpu_s = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+                       + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+
+    std::cout << "\n[ESPERA] Estrategia: " << Wait::NAME
+              << " | CPU: " << (100.0 * cpu_s / RUN_SECONDS) << "%"
+              << " | epoll_wait: " << c.blocks
+              << " | Escaladas: " << c.escalations
+              << " | Rajadas: " << c.bursts << std::endl;
+    std::cout << "[ESPERA] Latencia kernel->usuario (ns) P50: " << h.percentile(50)
+              << " | P99: " << h.percentile(99)
+              << " | P99.9: " << h.percentile(99.9)
+              << " | Max: " << h.max() << std::endl;
+    return st;
+}
 
-    try {
-        petronilho::RingBuffer ring("ring_audit.bin", 65536);
+template<typename Wait, typename Sink>
+static petronilho::net::IngestStats run_with(Backend& backend, Sink& sink) {
+    Wait wait;
+    return ingest_loop(backend, sink, wait);
+}
 
-        int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-        fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK);
+// Contadores proprios de cada politica de transbordo
+static void report_overflow(const petronilho::net::DropNewest& p) {
+    std::cout << "[TRANSBORDO] drop-newest | Descartados: " << p.counters().dropped << std::endl;
+}
 
-        sockaddr_in servaddr{};
-        servaddr.sin_family      = AF_INET;
-        servaddr.sin_addr.s_addr = INADDR_ANY;
-        servaddr.sin_port        = htons(9999);
-        bind(sockfd, (const struct sockaddr*)&servaddr, sizeof(servaddr));
+static void report_overflow(const petronilho::net::DropOldest& p) {
+    std::cout << "[TRANSBORDO] drop-oldest | Sobrescritos: " << p.counters().overwritten
+              << " | Descartados: " << p.counters().dropped << std::endl;
+}
 
-        std::cout << "[PETRONILHO CORE V5] Ring Buffer ativo. Capacidade: "
-                  << ring.capacity() << " slots." << std::endl;
+static void report_overflow(const petronilho::net::BlockWithTimeout& p) {
+    const auto& c = p.counters();
+    std::cout << "[TRANSBORDO] block " << p.timeout_ns() << "ns | Esperas: " << c.waits
+              << " | Timeouts: " << c.timeouts
+              << " | Parado: " << c.blocked_ns / 1000 << "us"
+              << " | Maior espera: " << c.max_wait_ns << "ns" << std::endl;
+}
 
-        char recv_buf[1472];
-        uint64_t count   = 0;
-        uint64_t dropped = 0;
+static void report_overflow(const petronilho::net::Spill& p) {
+    const auto& c = p.counters();
+    std::cout << "[TRANSBORDO] spill | Gravados: " << c.spilled
+              << " | Drenados: " << c.drained
+              << " | Pendentes: " << p.pending()
+              << " | Pico: " << c.pending_peak
+              << " | Arquivo cheio: " << c.spill_full << std::endl;
+}
 
-        auto start = std::chrono::steady_clock::now();
+template<typename Policy>
+static void report_sink(petronilho::net::RingSink<Policy>& sink) { report_overflow(sink.policy()); }
 
-        while (true) {
-            auto now     = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start).count();
-            if (elapsed >= 300) break;
+static void report_sink(petronilho::net::RingDirectSink& sink) {
+    std::cout << "[TRANSBORDO] ring-direct | Anel cheio (descartados): " << sink.overflow() << std::endl;
+}
 
-            auto t1  = std::chrono::high_resolution_clock::now();
-            ssize_t n = recv(sockfd, recv_buf, sizeof(recv_buf), 0);
-            auto t2  = std::chrono::high_resolution_clock::now();
+template<typename Sink>
+static petronilho::net::IngestStats run_policy(const char* strategy, Backend& backend, Sink& sink) {
+    petronilho::net::IngestStats totals;
+    if      (!std::strcmp(strategy, "spin"))  totals = run_with<petronilho::net::SpinWait>(backend, sink);
+    else if (!std::strcmp(strategy, "busy"))  totals = run_with<petronilho::net::BusyPollWait>(backend, sink);
+    else if (!std::strcmp(strategy, "block")) totals = run_with<petronilho::net::BlockingWait>(backend, sink);
+    else                                      totals = run_with<petronilho::net::AdaptiveWait>(backend, sink);
+    report_sink(sink);
+    return totals;
+}
 
-            if (n > 0) {
-                uint32_t lat = (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
-                uint64_t ts  = (uint64_t)t2.time_since_epoch().count();
+// Uso: main [lote recvmmsg] [spin|busy|block|adaptive] [gro|-]
+//           [newest|oldest|block|spill]
+int main(int argc, char** argv) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(2, &cpuset);
+    sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
+    std::cout << "[LINUX] Afinidade: Core 2." << std::endl;
 
-                if (!ring.write(ts, lat, (uint32_t)count, recv_buf, (uint32_t)n))
-                    dropped++;
+    try {
+        // Registros de tamanho variavel: o datagrama inteiro vai para
+        // o ring (ate 24 slots de 64B por datagrama de 1472 bytes).
+        // RECOVER: reiniciar o processo sob carga mantem o backlog nao
+        // lido da execucao anterior (exportado junto no CSV).
+        // "oldest" descarta movendo read_idx: so entao o anel paga o
+        // CAS do consumidor (RingOverflow::OVERWRITE)
+        const char* overflow = (argc > 4) ? argv[4] : "newest";
+        const auto  ring_overflow = !std::strcmp(overflow, "oldest")
+            ? petronilho::RingOverflow::OVERWRITE : petronilho::RingOverflow::REJECT;
+        petronilho::RingBuffer ring("ring_audit.bin", 1 << 20, petronilho::RingMode::VARIABLE,
+                                    petronilho::RingOpen::RECOVER, petronilho::platform::PageHint::HUGE,
+                                    ring_overflow);
+        if (ring.recovery().reopened)
+            std::cout << "[RECUPERACAO] ring_audit.bin: " << ring.recovery().records
+                      << " registros nao lidos recuperados, " << ring.recovery().slots_dropped
+                      << " slots corrompidos descartados." << std::endl;
+
+        const uint32_t batch = (argc > 1) ? (uint32_t)std::atoi(argv[1]) : 32;
+        const char* strategy = (argc > 2) ? argv[2] : "adaptive";
+        const bool  want_gro = (argc > 3) && !std::strcmp(argv[3], "gro");
+
+        int sockfd = petronilho::net::open_udp_socket({ .port = 9999, .non_blocking = true });
+        if (sockfd < 0) { perror("Socket/bind erro"); return 1; }
+
+        // UDP_GRO: cada mensagem pode trazer varios datagramas
+        // coalescidos, entao o buffer sobe para 64KB.
+        static Backend backend(sockfd, batch, DGRAM_SIZE);
+        const bool gro = want_gro && backend.enable_gro();
+
+        // Slots de recepcao giram numa area da arena; o ring recebe
+        // uma copia do payload inteiro em slots contiguos.
+        const size_t arena_size = (size_t)MAX_BATCH * petronilho::net::GRO_MAX_MESSAGE * 4;
+        petronilho::sys::ScalableArena arena(arena_size, petronilho::platform::PageHint::HUGE);
+        if (arena.capacity() == 0) { perror("mmap arena"); return 1; }
+        auto scratch = arena.allocate<uint8_t>(arena_size / 2);
+
+        // Carimbo RX do kernel: latencia = espera na fila do socket
+        // + syscall, e nao so o tempo gasto dentro do recv.
+        const auto ts_mode = petronilho::net::enable_rx_timestamps(sockfd);
 
-                if (++count % 100000 == 0) {
-                    std::cout << "\r[MONITOR] " << elapsed << "s | Pacotes: " << count
-                              << " | Buffer: " << ring.size() << "/" << ring.capacity()
-                              << " | Descartados: " << dropped << std::flush;
-                }
-            }
+        std::cout << "[PETRONILHO CORE V5] Ring Buffer ativo. Capacidade: "
+                  << ring.capacity() << " slots. Lote recvmmsg: "
+                  << backend.receiver().batch() << " | Carimbo RX: "
+                  << (ts_mode == petronilho::net::RxTimestampMode::NONE
+                      ? "indisponivel (mede so a syscall)" : "kernel")
+                  << " | Espera: " << strategy
+                  << " | UDP_GRO: " << (gro ? "ligado" : "desligado")
+                  << " | Ring cheio: " << overflow << std::endl;
+        std::cout << "[PAGINAS] Ring: " << petronilho::platform::page_size_name(ring.page_size())
+                  << " | Arena: " << petronilho::platform::page_size_name(arena.page_size())
+                  << std::endl;
+
+        // Padrao: recvmmsg escreve direto nas reservas do ring (sem
+        // copia); ring cheio descarta o novo. As outras politicas e o
+        // GRO passam pelo RingSink (uma copia): sobrescrever o mais
+        // antigo, esperar o leitor ate 100us ou transbordar para
+        // ring_spill.bin e devolver ao ring quando houver espaco.
+        petronilho::net::IngestStats totals;
+        void* const  scratch_mem   = scratch.get_ptr();
+        const size_t scratch_bytes = arena_size / 2;
+        if (!std::strcmp(overflow, "oldest")) {
+            petronilho::net::RingSink<petronilho::net::DropOldest> sink(ring, scratch_mem, scratch_bytes);
+            totals = run_policy(strategy, backend, sink);
+        } else if (!std::strcmp(overflow, "block")) {
+            petronilho::net::RingSink<petronilho::net::BlockWithTimeout> sink(
+                ring, scratch_mem, scratch_bytes, petronilho::net::BlockWithTimeout(100000));
+            totals = run_policy(strategy, backend, sink);
+        } else if (!std::strcmp(overflow, "spill")) {
+            petronilho::PersistentArena spill_file("ring_spill.bin", SPILL_SIZE);
+            petronilho::net::RingSink<petronilho::net::Spill> sink(
+                ring, scratch_mem, scratch_bytes, petronilho::net::Spill(spill_file));
+            totals = run_policy(strategy, backend, sink);
+        } else if (gro) {
+            petronilho::net::RingSink<> sink(ring, scratch_mem, scratch_bytes);
+            totals = run_policy(strategy, backend, sink);
+        } else {
+            petronilho::net::RingDirectSink sink(ring, scratch_mem, scratch_bytes);
+            totals = run_policy(strategy, backend, sink);
         }
+        const uint64_t count   = totals.packets;
+        const uint64_t dropped = totals.dropped;
 
         std::cout << "\n[FINALIZANDO] Exportando CSV..." << std::endl;
         std::ofstream csv("petronilho_ring_5min.csv");
-        csv << "ID,TS_NS,LAT_NS\n";
+        csv << "ID,TS_NS,LAT_NS,LEN\n";
 
-        petronilho::RingSlot slot;
+        // Leitura no lugar: peek/release, sem copiar o slot
         uint64_t exported = 0;
-        while (ring.read(slot)) {
-            csv << slot.packet_id << "," << slot.timestamp_ns << "," << slot.latency_ns << "\n";
+        while (const petronilho::RingSlot* slot = ring.peek()) {
+            csv << slot->packet_id << "," << slot->timestamp_ns << "," << slot->latency_ns
+                << "," << slot->payload_len << "\n";
+            (void)ring.release();
             exported++;
         }
+        // Cursores e slots em disco: a proxima execucao parte daqui
+        (void)ring.sync();
 
         std::cout << "[SUCESSO] Processado: " << count   << std::endl;
         std::cout << "[SUCESSO] Exportado : " << exported << std::endl;
         std::cout << "[SUCESSO] Descartados: " << dropped  << std::endl;
+        std::cout << "[SUCESSO] Pkt/syscall: " << totals.packets_per_poll()
+                  << " (" << totals.productive << " recvmmsg produtivos, "
+                  << backend.receiver().packets_per_syscall() << " msg/syscall)" << std::endl;
 
         close(sockfd);
 
@@ -1,69 +1,61 @@
 #include <iostream>
-#include <atomic>
-#include <chrono>
-#include <sys/mman.h>
-#include <fcntl.h>
-#include <unistd.h>
+#include <cstdio>
 #include <netinet/in.h>
-
-// 1. HEADER DE PACOTE (Metadados para Auditoria)
-struct RecordHeader {
-    uint64_t timestamp_ns;
-    uint32_t payload_len;
-    uint32_t magic; // 0xDEADBEEF
-};
+#include "core/sys/persistent_arena.hpp"
+#include "core/sys/udp_socket.hpp"
+#include "core/sys/rx_timestamp.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
+
+// 1. REGISTRO DE AUDITORIA
+// Cada datagrama vira JournalRecord (timestamp, tamanho, magic
+// 0xDEADBEEF, latencia) + payload no log mmap (ingest_sinks.hpp).
 
 int main() {
     const char* filename = "prod_audit.log";
     const size_t ARENA_SIZE = 1024ULL * 1024 * 512; // 512MB
 
-    // 2. RECUPERAÇÃO DE ESTADO
-    // Tentamos abrir o arquivo existente para ler o tamanho e continuar de onde parou
-    int fd = open(filename, O_RDWR | O_CREAT, 0666);
-    size_t current_file_size = lseek(fd, 0, SEEK_END);
-    if (current_file_size < ARENA_SIZE) ftruncate(fd, ARENA_SIZE);
+    // 2. LOG MMAP (pre-carregado: sem page fault no caminho quente;
+    // paginas grandes quando o fs permite: menos faltas de TLB)
+    petronilho::PersistentArena log(filename, ARENA_SIZE, petronilho::platform::PageHint::HUGE);
 
-    // 3. HUGE PAGES (Blindagem de Performance)
-    // Tentamos MAP_HUGETLB. Se o sistema não suportar, ele cai para o mmap padrão automaticamente.
-    void* memory = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_WRITE, 
-                        MAP_SHARED | MAP_POPULATE, fd, 0);
+    int sockfd = petronilho::net::open_udp_socket({ .port = 9999, .non_blocking = true });
+    if (sockfd < 0) { perror("Socket/bind erro"); return 1; }
+    (void)petronilho::net::enable_rx_timestamps(sockfd);
 
-    if (memory == MAP_FAILED) {
-        std::cout << "[AVISO] Huge Pages não disponíveis. Usando páginas padrão." << std::endl;
-        memory = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    }
+    std::cout << "[PETRONILHO V5] Core Ativo. Gravando em: " << filename
+              << " | Paginas: " << petronilho::platform::page_size_name(log.page_size()) << std::endl;
+
+    // 3. MOTOR: recvmmsg direto nos registros do log (Zero-Copy),
+    // epoll quando o socket esvazia (mesma espera do MSG_WAITFORONE).
+    using namespace petronilho::net;
+    constexpr uint32_t BATCH = 32;
+    typedef RecvmmsgBackend<BATCH> Backend;
 
-    uint8_t* ptr = (uint8_t*)memory;
-    
-    // Recupera o offset real (procura o último Magic Number válido ou começa do zero)
-    // Para simplificar no MVP, vamos apenas anexar (append) se o arquivo já tiver dados.
-    std::atomic<size_t> offset{0};
-    
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    sockaddr_in addr{AF_INET, htons(9999), {INADDR_ANY}};
-    bind(sockfd, (const struct sockaddr *)&addr, sizeof(addr));
+    Backend        backend(sockfd, BATCH, 1472);
+    PersistentSink sink(log);
+    BlockingWait   wait;
+    IngestEngine<Backend, PersistentSink, BlockingWait> engine(backend, sink, wait);
+    if (!engine.attach()) { perror("epoll"); return 1; }
 
-    std::cout << "[PETRONILHO V5] Core Ativo. Gravando em: " << filename << std::endl;
+    const IngestStats& st = engine.stats();
+    uint64_t next_report = 1000000;
+    uint64_t resets      = 0;
 
     while (true) {
-        size_t needed = sizeof(RecordHeader) + 1472;
-        size_t curr_off = offset.fetch_add(needed, std::memory_order_relaxed);
+        engine.step();
 
-        if (curr_off + needed > ARENA_SIZE) {
+        if (sink.resets() != resets) {
+            resets = sink.resets();
             std::cout << "[LOG] Arena Cheia. Reiniciando ciclo." << std::endl;
-            offset.store(0); 
-            continue;
         }
 
-        RecordHeader* h = (RecordHeader*)(ptr + curr_off);
-        
-        // Recebe o dado (Zero-Copy)
-        ssize_t n = recv(sockfd, ptr + curr_off + sizeof(RecordHeader), 1472, 0);
-        
-        if (n > 0) {
-            h->timestamp_ns = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            h->payload_len = (uint32_t)n;
-            h->magic = 0xDEADBEEF;
+        if (st.packets >= next_report) {
+            next_report += 1000000;
+            std::cout << "[MONITOR] Pacotes: " << st.packets
+                      << " | Pkt/syscall: " << st.packets_per_poll() << std::endl;
         }
     }
     return 0;
@@ -0,0 +1,98 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// test_arena_stats.cpp - Contadores de arena (PETRONILHO_ARENA_STATS)
+// ================================================================
+//
+// 1. Uma thread que usa mais arenas que TLS_SLOTS tem o chunk
+//    despejado e volta a alocar: continua um slot so por arena, e
+//    o resto do chunk despejado aparece em tail_waste da dona.
+// 2. Despejo do chunk de uma arena ja destruida nao toca nela.
+// 3. ArenaStats::add fica com o maior high-water, nao a soma.
+//
+// Retorna 0 se tudo confere; imprime cada falha.
+// ================================================================
+
+#include "core/sys/arena.hpp"
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace petronilho;
+
+static int g_failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { \
+    std::printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); ++g_failures; } } while (0)
+
+static constexpr size_t ARENA_BYTES = 4 << 20;
+static constexpr size_t N           = 1000;   // bytes por alocacao
+
+// ----------------------------------------------------------------
+static void eviction() {
+    sys::ScalableArena owner(ARENA_BYTES, platform::PageHint::SMALL);
+
+    std::thread t([&] {
+        for (uint32_t round = 0; round < 8; ++round) {
+            CHECK(!owner.allocate<uint8_t>(N, sys::ArenaTag::HEAP).is_null());
+
+            // TLS_SLOTS outras arenas: o chunk de owner e despejado
+            std::vector<std::unique_ptr<sys::ScalableArena>> others;
+            for (uint32_t i = 0; i < sys::ArenaConfig::TLS_SLOTS; ++i) {
+                others.push_back(std::make_unique<sys::ScalableArena>(
+                    ARENA_BYTES, platform::PageHint::SMALL));
+                (void)others.back()->allocate<uint8_t>(N);
+            }
+        }
+    });
+    t.join();
+
+    const sys::ArenaStats s = owner.stats();
+    CHECK(s.enabled);
+    CHECK(s.threads == 1);
+    CHECK(s.allocations == 8);
+    CHECK(s.tag_allocs[static_cast<uint32_t>(sys::ArenaTag::HEAP)] == 8);
+    CHECK(s.refills == 8);
+    // Cada chunk de owner foi despejado com N bytes usados
+    CHECK(s.tail_waste == 8 * (sys::ArenaConfig::TLS_CHUNK_MIN - N));
+    CHECK(s.high_water == 8 * sys::ArenaConfig::TLS_CHUNK_MIN);
+}
+
+// ----------------------------------------------------------------
+static void evicted_owner_gone() {
+    std::thread t([] {
+        {
+            sys::ScalableArena gone(ARENA_BYTES, platform::PageHint::SMALL);
+            (void)gone.allocate<uint8_t>(64);
+        }
+        std::vector<std::unique_ptr<sys::ScalableArena>> others;
+        for (uint32_t i = 0; i < sys::ArenaConfig::TLS_SLOTS; ++i) {
+            others.push_back(std::make_unique<sys::ScalableArena>(
+                ARENA_BYTES, platform::PageHint::SMALL));
+            CHECK(!others.back()->allocate<uint8_t>(64).is_null());
+        }
+        for (auto& a : others) CHECK(a->stats().tail_waste == 0);
+    });
+    t.join();
+}
+
+// ----------------------------------------------------------------
+static void add_keeps_max_high_water() {
+    sys::ArenaStats a, b;
+    a.high_water = 300;
+    b.high_water = 500;
+    a.refills = 2;
+    b.refills = 3;
+    a.add(b);
+    CHECK(a.high_water == 500);
+    CHECK(a.refills == 5);
+}
+
+int main() {
+    eviction();
+    evicted_owner_gone();
+    add_keeps_max_high_water();
+    std::printf("test_arena_stats: %s (%d falhas)\n", g_failures ? "FALHOU" : "OK", g_failures);
+    return g_failures ? 1 : 0;
+}
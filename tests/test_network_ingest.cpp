@@ -1,4 +1,10 @@
-#include "arena.hpp"
+#include "core/sys/arena.hpp"
+#include "core/sys/udp_socket.hpp"
+#include "core/sys/rx_timestamp.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -11,6 +17,7 @@
 #include <fcntl.h>
 #include <fstream>   // Necessário para o LOG
 #include <iomanip>
+#include <cstdlib>
 
 using namespace std::chrono;
 
@@ -33,52 +40,55 @@ std::atomic<uint64_t> bytes_received{0};
 // Buffer global para não interferir na Arena de dados
 PerfMetrics* telemetry_log = new PerfMetrics[MAX_LOG_ENTRIES];
 
-void network_ingest_worker(petronilho::ScalableArena* arena) {
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+typedef petronilho::net::RecvmmsgBackend<32>  Backend;
+typedef petronilho::net::QueueSink<16384>      Sink;
+typedef petronilho::net::SpinWait              Wait;
+
+// Ingestao: IngestEngine<recvmmsg, queue, spin>. Os datagramas
+// caem direto em slots da ScalableArena e seguem por descritor.
+void network_ingest_worker(Sink* sink) {
+    int sockfd = petronilho::net::open_udp_socket({ .port = PORT, .non_blocking = true });
     if (sockfd < 0) return;
 
-    // Otimização de Socket
-    int flags = fcntl(sockfd, F_GETFL, 0);
-    fcntl(sockfd, F_SETFL, flags | O_NONBLOCK);
-    
-    sockaddr_in servaddr{};
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_addr.s_addr = INADDR_ANY;
-    servaddr.sin_port = htons(PORT);
+    // Carimbo RX do kernel: a latencia auditada inclui a espera
+    // do pacote na fila do socket, nao so o custo do recv.
+    (void)petronilho::net::enable_rx_timestamps(sockfd);
 
-    if (bind(sockfd, (const struct sockaddr *)&servaddr, sizeof(servaddr)) < 0) return;
+    Backend backend(sockfd, 32, PACKET_SIZE);
+    Wait    wait;
+    petronilho::net::IngestEngine<Backend, Sink, Wait> engine(backend, *sink, wait);
+    (void)engine.attach();
 
+    const auto& st = engine.stats();
     while (running.load(std::memory_order_relaxed)) {
-        void* buffer = arena->allocate(PACKET_SIZE);
-        if (!buffer) { arena->reset(); buffer = arena->allocate(PACKET_SIZE); }
-
-        // --- INÍCIO DA AUDITORIA ---
-        auto t1 = high_resolution_clock::now();
-
-        ssize_t n = recv(sockfd, buffer, PACKET_SIZE, 0);
-        
-        if (n > 0) {
-            auto t2 = high_resolution_clock::now();
-            uint64_t lat = duration_cast<nanoseconds>(t2 - t1).count();
-            uint64_t current_idx = packets_received.load(std::memory_order_relaxed);
-
-            // Grava no log de memória (O(1) complexity)
-            if (current_idx < MAX_LOG_ENTRIES) {
-                telemetry_log[current_idx] = { current_idx, (uint64_t)t2.time_since_epoch().count(), lat };
-            }
-
-            packets_received.fetch_add(1, std::memory_order_relaxed);
-            bytes_received.fetch_add(n, std::memory_order_relaxed);
-        }
+        if (engine.step() <= 0) continue;
+        packets_received.store(st.packets, std::memory_order_relaxed);
+        bytes_received.store(st.bytes, std::memory_order_relaxed);
     }
     close(sockfd);
 }
 
+// Auditoria: consome os descritores e grava no log de memoria
+void audit_worker(Sink* sink) {
+    petronilho::net::Datagram d;
+    while (running.load(std::memory_order_relaxed)) {
+        if (!sink->pop(d)) continue;
+        // Grava no log de memória (O(1) complexity)
+        if (d.seq < MAX_LOG_ENTRIES)
+            telemetry_log[d.seq] = { d.seq, d.rx_ns, d.lat_ns };
+        sink->done(d);
+    }
+}
+
 int main() {
-    petronilho::ScalableArena arena(ARENA_SIZE);
+    void* arena_mem = nullptr;
+    if (posix_memalign(&arena_mem, 4096, ARENA_SIZE) != 0) return 1;
+    petronilho::sys::ScalableArena arena(arena_mem, ARENA_SIZE);
+    static Sink sink(arena);
     std::cout << "[INGESTOR] Petronilho Core Ativo | Auditoria: Ativa (1M registros)" << std::endl;
     
-    std::thread ingest_thread(network_ingest_worker, &arena);
+    std::thread ingest_thread(network_ingest_worker, &sink);
+    std::thread audit_thread(audit_worker, &sink);
 
     // Monitor de console (Dono do dinheiro gosta de ver movimento)
     for(int i=0; i<10; ++i) {
@@ -91,6 +101,7 @@ int main() {
     std::cout << "\n[SISTEMA] Finalizando e gerando relatório CSV..." << std::endl;
     running = false;
     ingest_thread.join();
+    audit_thread.join();
 
     // --- GERAÇÃO DO CSV DE AUDITORIA ---
     std::ofstream csv("petronilho_audit.csv");
@@ -107,5 +118,6 @@ int main() {
     std::cout << "[SUCESSO] Arquivo 'petronilho_audit.csv' gerado com " << total << " registros." << std::endl;
 
     delete[] telemetry_log;
+    free(arena_mem);
     return 0;
 }
\ No newline at end of file
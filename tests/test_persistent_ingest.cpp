@@ -1,4 +1,10 @@
-#include "persistent_arena.hpp"
+#include "core/sys/persistent_arena.hpp"
+#include "core/sys/udp_socket.hpp"
+#include "core/sys/rx_timestamp.hpp"
+#include "core/sys/wait_strategy.hpp"
+#include "core/sys/ingest_engine.hpp"
+#include "core/sys/ingest_backends.hpp"
+#include "core/sys/ingest_sinks.hpp"
 #include <iostream>
 #include <thread>
 #include <atomic>
@@ -6,28 +12,88 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
-int main() {
-    // 1GB de Journal Persistente mapeado em disco
-    const size_t ARENA_SIZE = 1ULL * 1024 * 1024 * 1024; 
-    petronilho::PersistentArena arena("supercore.journal", ARENA_SIZE);
+constexpr uint32_t BATCH = 32;
+
+typedef petronilho::net::RecvmmsgBackend<BATCH> Backend;
+typedef petronilho::net::PersistentSink         Sink;
 
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sockfd < 0) { perror("Socket erro"); return 1; }
+// ================================================================
+// persist_loop - IngestEngine<recvmmsg, persistent, Wait>
+// Cada iovec aponta para um registro do journal; slots nao
+// preenchidos sao reaproveitados, sem buracos no arquivo.
+// Wait: SpinWait, BusyPollWait, BlockingWait ou AdaptiveWait
+// ================================================================
+template<typename Wait>
+static void persist_loop(Backend& backend, Sink& sink, Wait& wait,
+                         std::atomic<uint64_t>& packets,
+                         std::atomic<uint64_t>& bytes,
+                         std::atomic<uint64_t>& syscalls) {
+    petronilho::net::IngestEngine<Backend, Sink, Wait> engine(backend, sink, wait);
+    if (!engine.attach())
+        std::cout << "[AVISO] " << Wait::NAME << ": configuracao parcial" << std::endl;
+
+    const auto& st = engine.stats();
+    uint64_t next_report = 1000000;
+    uint64_t resets      = 0;
+
+    while (true) {
+        if (engine.step() <= 0) continue;
 
-    sockaddr_in servaddr{};
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_addr.s_addr = INADDR_ANY;
-    servaddr.sin_port = htons(9999);
+        // Contadores do motor sao da thread de ingestao: o monitor
+        // le copias atomicas atualizadas por lote
+        packets.store(st.packets, std::memory_order_relaxed);
+        bytes.store(st.bytes, std::memory_order_relaxed);
+        syscalls.store(st.productive, std::memory_order_relaxed);
 
-    if (bind(sockfd, (const struct sockaddr *)&servaddr, sizeof(servaddr)) < 0) {
-        perror("Bind erro"); return 1;
+        if (sink.resets() != resets) {
+            resets = sink.resets();
+            std::cout << "[AVISO] Arena Persistente Cheia. Reiniciando..." << std::endl;
+        }
+
+        // Histograma e da thread de ingestao: relatorio sai daqui
+        if (st.packets >= next_report) {
+            next_report += 1000000;
+            const auto& h = wait.histogram();
+            std::cout << "[ESPERA] " << Wait::NAME
+                      << " | Latencia kernel->usuario (ns) P50: " << h.percentile(50)
+                      << " | P99: " << h.percentile(99)
+                      << " | P99.9: " << h.percentile(99.9)
+                      << " | epoll_wait: " << wait.counters().blocks << std::endl;
+        }
     }
+}
 
-    std::cout << "[PERSISTENCE] Petronilho Core gravando em supercore.journal..." << std::endl;
+template<typename Wait>
+static void run_with(Backend& backend, Sink& sink,
+                     std::atomic<uint64_t>& packets,
+                     std::atomic<uint64_t>& bytes,
+                     std::atomic<uint64_t>& syscalls) {
+    Wait wait;
+    persist_loop(backend, sink, wait, packets, bytes, syscalls);
+}
+
+// Uso: test_persistent_ingest [spin|busy|block|adaptive]
+int main(int argc, char** argv) {
+    const char* strategy = (argc > 1) ? argv[1] : "adaptive";
+
+    // 1GB de Journal Persistente mapeado em disco
+    const size_t ARENA_SIZE = 1ULL * 1024 * 1024 * 1024; 
+    petronilho::PersistentArena arena("supercore.journal", ARENA_SIZE);
+
+    int sockfd = petronilho::net::open_udp_socket({ .port = 9999, .non_blocking = true });
+    if (sockfd < 0) { perror("Socket/bind erro"); return 1; }
+    (void)petronilho::net::enable_rx_timestamps(sockfd);
+
+    std::cout << "[PERSISTENCE] Petronilho Core gravando em supercore.journal... Espera: "
+              << strategy << std::endl;
 
     std::atomic<uint64_t> packets{0};
     std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> syscalls{0};
     
     std::thread monitor([&]() {
         auto start = std::chrono::steady_clock::now();
@@ -35,25 +101,21 @@ int main() {
             std::this_thread::sleep_for(std::chrono::seconds(1));
             double gb_total = (bytes.load() * 8.0) / 1e9;
             std::cout << "[MONITOR] Pacotes no NVMe: " << packets.load() 
-                      << " | Escrito: " << std::fixed << std::setprecision(2) << gb_total << " Gb" << std::endl;
+                      << " | Escrito: " << std::fixed << std::setprecision(2) << gb_total << " Gb"
+                      << " | Pkt/syscall: " << (double)packets.load() / std::max<uint64_t>(syscalls.load(), 1)
+                      << std::endl;
         }
     });
     monitor.detach();
 
-    while (true) {
-        void* buffer = arena.allocate(1500);
-        if (!buffer) {
-            std::cout << "[AVISO] Arena Persistente Cheia. Reiniciando..." << std::endl;
-            arena.reset();
-            buffer = arena.allocate(1500);
-        }
+    Backend backend(sockfd, BATCH, 1500);
+    Sink    sink(arena);
 
-        ssize_t n = recv(sockfd, buffer, 1500, 0);
-        if (n > 0) {
-            packets.fetch_add(1, std::memory_order_relaxed);
-            bytes.fetch_add(n, std::memory_order_relaxed);
-        }
-    }
+    using namespace petronilho::net;
+    if      (!std::strcmp(strategy, "spin"))  run_with<SpinWait>(backend, sink, packets, bytes, syscalls);
+    else if (!std::strcmp(strategy, "busy"))  run_with<BusyPollWait>(backend, sink, packets, bytes, syscalls);
+    else if (!std::strcmp(strategy, "block")) run_with<BlockingWait>(backend, sink, packets, bytes, syscalls);
+    else                                      run_with<AdaptiveWait>(backend, sink, packets, bytes, syscalls);
 
     return 0;
 }
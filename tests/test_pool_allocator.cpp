@@ -0,0 +1,141 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// test_pool_allocator.cpp - SizeClassPool entre threads
+// ================================================================
+//
+// 1. Uma thread aloca, outra libera (recepcao -> logica): cada
+//    bloco chega com a marca de quem o alocou, nenhum e entregue
+//    duas vezes ao mesmo tempo e a memoria tomada da arena para de
+//    crescer (os blocos giram pelo deposito).
+// 2. Despejo de cache: uma thread que usa mais pools que
+//    TLS_SLOTS devolve o cache despejado ao deposito do dono.
+// 3. Despejo do cache de um pool ja destruido nao toca nele.
+//
+// Retorna 0 se tudo confere; imprime cada falha.
+// ================================================================
+
+#include "core/sys/pool_allocator.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+using namespace petronilho;
+
+static int g_failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { \
+    std::printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); ++g_failures; } } while (0)
+
+struct Block {
+    uint64_t id;
+    uint64_t fill[15];
+};
+
+// ----------------------------------------------------------------
+static void cross_thread() {
+    constexpr uint32_t RING  = 1024;     // blocos em voo, no maximo
+    constexpr uint64_t TOTAL = 400000;
+
+    sys::ScalableArena arena(16 << 20, platform::PageHint::SMALL);
+    sys::SizeClassPool pool(arena);
+
+    sys::Handle<Block>    slots[RING];
+    std::atomic<uint64_t> head{0}, tail{0};   // SPSC: produtor escreve tail
+    std::atomic<uint64_t> bad{0}, nulls{0};
+    uint64_t carved_mid = 0;
+
+    std::thread producer([&] {
+        for (uint64_t id = 0; id < TOTAL; ++id) {
+            while (id - head.load(std::memory_order_acquire) >= RING) sched_yield();
+            auto h = pool.allocate<Block>();
+            if (h.is_null()) { nulls.fetch_add(1); break; }
+            Block* b = h.get_ptr();
+            b->id = id;
+            for (auto& w : b->fill) w = id * 0x9E3779B97F4A7C15ull;
+            slots[id % RING] = h;
+            tail.store(id + 1, std::memory_order_release);
+        }
+        pool.flush_thread();
+    });
+
+    std::thread consumer([&] {
+        for (uint64_t id = 0; id < TOTAL; ++id) {
+            while (tail.load(std::memory_order_acquire) == id) {
+                if (nulls.load()) return;
+                sched_yield();
+            }
+            auto h = slots[id % RING];
+            Block* b = h.get_ptr();
+            bool ok = b->id == id;
+            for (auto w : b->fill) ok = ok && w == id * 0x9E3779B97F4A7C15ull;
+            if (!ok) bad.fetch_add(1);
+            // Marca de liberado: um bloco reentregue em uso apareceria
+            // com id trocado no proximo alocador
+            b->id = ~0ull;
+            pool.deallocate(h);
+            head.store(id + 1, std::memory_order_release);
+            if (id == TOTAL / 2) carved_mid = pool.carved();
+        }
+        pool.flush_thread();
+    });
+
+    producer.join();
+    consumer.join();
+
+    CHECK(nulls.load() == 0);
+    CHECK(bad.load() == 0);
+    // Segunda metade reusa blocos: no maximo um talho a mais por lado
+    CHECK(pool.carved() <= carved_mid + 2 * sys::PoolConfig::CARVE_MAX);
+    CHECK(pool.carved() < TOTAL * sizeof(Block) / 10);
+}
+
+// ----------------------------------------------------------------
+static void eviction_returns_blocks() {
+    sys::ScalableArena arena(16 << 20, platform::PageHint::SMALL);
+    sys::SizeClassPool owner(arena);
+
+    std::thread t([&] {
+        // Menos que CACHE_MAX: os blocos ficam no cache da thread
+        constexpr uint32_t N = 40;
+        sys::Handle<Block> hs[N];
+        for (auto& h : hs) h = owner.allocate<Block>();
+        for (auto& h : hs) owner.deallocate(h);
+        const uint32_t before = owner.depot_batches(sizeof(Block));
+
+        // TLS_SLOTS outros pools: o cache de owner e despejado
+        std::vector<std::unique_ptr<sys::SizeClassPool>> others;
+        for (uint32_t i = 0; i < sys::PoolConfig::TLS_SLOTS; ++i) {
+            others.push_back(std::make_unique<sys::SizeClassPool>(arena));
+            (void)others.back()->allocate<Block>();
+        }
+        CHECK(owner.depot_batches(sizeof(Block)) > before);
+
+        // O que voltou ao deposito e reusado, sem talho novo
+        const uint64_t carved = owner.carved();
+        std::thread u([&] {
+            for (uint32_t i = 0; i < N; ++i) CHECK(!owner.allocate<Block>().is_null());
+        });
+        u.join();
+        CHECK(owner.carved() == carved);
+
+        // Pool destruido com cache nesta thread: o despejo o ignora
+        others.clear();
+        for (uint32_t i = 0; i < sys::PoolConfig::TLS_SLOTS; ++i) {
+            sys::SizeClassPool p(arena);
+            (void)p.allocate<Block>();
+        }
+    });
+    t.join();
+}
+
+int main() {
+    cross_thread();
+    eviction_returns_blocks();
+    std::printf("test_pool_allocator: %s (%d falhas)\n", g_failures ? "FALHOU" : "OK", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,415 @@
+// Layer: L1 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// test_ring_buffer.cpp - Registros VARIABLE e recuperacao por CRC
+// ================================================================
+//
+// 1. Registros de tamanhos variados dando muitas voltas num anel
+//    pequeno: cada um volta inteiro e em ordem, inclusive os que
+//    precisam de PAD no fim do anel.
+// 1b. Payload FIXED: 40 bytes por registro sem recuperacao, 32 com
+//    RECOVER (selo seq/crc no slot); read(), read_batch() e peek()
+//    entregam os bytes certos nos dois layouts.
+// 2. Limite de span: anel maior que RING_MAX_SPAN slots aceita
+//    max_record() e recusa um byte a mais.
+// 2b. Registro grande com write_idx perto do fim do anel (PAD +
+//    registro): max_record() sempre cabe, mesmo depois do PAD; mais
+//    que metade do anel e recusado sem mexer em read_idx, com
+//    REJECT e com OVERWRITE.
+// 3. Escrita rasgada: um registro corrompido no arquivo vira PAD
+//    na reabertura (RECOVER); os demais voltam intactos.
+// 3b. read_batch cujo lote e so o PAD do fim do anel (write_idx
+//    visto pelo consumidor termina no PAD) segue do slot 0 e entrega
+//    o registro gravado depois, em vez de devolver 0.
+// 4. Produtor e consumidor em threads, nos dois protocolos de
+//    read_idx: REJECT (store do consumidor) entrega tudo em ordem;
+//    OVERWRITE (CAS) entrega em ordem crescente, sem payload rasgado.
+//
+// Retorna 0 se tudo confere; imprime cada falha.
+// ================================================================
+
+#include "core/sys/ring_buffer.hpp"
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <sched.h>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace petronilho;
+
+static int g_failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { \
+    std::printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); ++g_failures; } } while (0)
+
+static uint8_t pattern(uint32_t id, uint32_t b) noexcept {
+    return static_cast<uint8_t>(id * 31 + b);
+}
+
+static void fill(std::vector<uint8_t>& buf, uint32_t id, uint32_t len) {
+    buf.resize(len);
+    for (uint32_t b = 0; b < len; ++b) buf[b] = pattern(id, b);
+}
+
+static bool intact(const uint8_t* p, uint32_t id, uint32_t len) noexcept {
+    for (uint32_t b = 0; b < len; ++b)
+        if (p[b] != pattern(id, b)) return false;
+    return true;
+}
+
+// ----------------------------------------------------------------
+static void variable_wrap() {
+    const char* path = "test_ring_wrap.bin";
+    {
+        RingBuffer ring(path, 64, RingMode::VARIABLE);
+        std::vector<uint8_t> in, out(ring.max_record());
+        uint32_t next_write = 0, next_read = 0;
+
+        // Ate 15 slots por registro num anel de 64: o fim do anel e
+        // cruzado (PAD) a cada poucos registros
+        auto len_of = [](uint32_t id) { return (id * 97u) % 900u + 1u; };
+
+        for (int round = 0; round < 2000; ++round) {
+            for (;;) {
+                fill(in, next_write, len_of(next_write));
+                if (!ring.write(next_write, 0, next_write, in.data(), len_of(next_write))) break;
+                ++next_write;
+            }
+            // Le so parte: a proxima rodada escreve sobre slots ja
+            // lidos com o restante ainda no anel
+            for (int k = 0; k < 3; ++k) {
+                RingSlot hdr;
+                const int64_t n = ring.read_record(hdr, out.data(),
+                                                   static_cast<uint32_t>(out.size()));
+                if (n < 0) break;
+                CHECK(hdr.packet_id == next_read);
+                CHECK(hdr.payload_len == len_of(next_read));
+                CHECK(n == static_cast<int64_t>(len_of(next_read)));
+                CHECK(intact(out.data(), next_read, static_cast<uint32_t>(n)));
+                ++next_read;
+            }
+        }
+        RingSlot hdr;
+        while (ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size())) >= 0) {
+            CHECK(hdr.packet_id == next_read);
+            CHECK(intact(out.data(), next_read, hdr.payload_len));
+            ++next_read;
+        }
+        CHECK(next_read == next_write);
+        CHECK(next_write > 64 * 20);   // deu muitas voltas
+    }
+    unlink(path);
+}
+
+// ----------------------------------------------------------------
+static void fixed_inline(RingOpen open_mode, uint32_t expect) {
+    const char* path = "test_ring_fixed.bin";
+    unlink(path);
+    {
+        RingBuffer ring(path, 64, RingMode::FIXED, open_mode);
+        CHECK(ring.inline_bytes() == expect);
+        CHECK(ring.max_record() == expect);
+
+        std::vector<uint8_t> in;
+        for (uint32_t id = 0; id < 3; ++id) {
+            fill(in, id, 50);
+            CHECK(ring.write(id, 0, id, in.data(), 50));
+        }
+        RingSlot hdr;
+        CHECK(ring.read(hdr));
+        CHECK(hdr.payload_len == expect);
+        CHECK(intact(hdr.payload, 0, expect));
+
+        RingSlot batch[1];
+        CHECK(ring.read_batch(batch, 1) == 1);
+        CHECK(batch[0].payload_len == expect);
+        CHECK(intact(batch[0].payload, 1, expect));
+
+        const RingSlot* slot = ring.peek();
+        CHECK(slot != nullptr);
+        if (slot) {
+            CHECK(slot->payload_len == expect);
+            CHECK(intact(ring.payload_of(*slot), 2, expect));
+            CHECK(ring.release());
+        }
+        CHECK(ring.empty());
+    }
+    unlink(path);
+}
+
+// ----------------------------------------------------------------
+static void span_limit() {
+    const char* path = "test_ring_span.bin";
+    {
+        RingBuffer ring(path, size_t(1) << 17, RingMode::VARIABLE);
+        const size_t max = ring.max_record();
+        CHECK(max == size_t(RING_MAX_SPAN - 1) * sizeof(RingSlot) + RING_INLINE_BYTES);
+
+        std::vector<uint8_t> in, out(max + 1);
+        fill(in, 7, static_cast<uint32_t>(max + 1));
+        CHECK(!ring.write(0, 0, 1, in.data(), static_cast<uint32_t>(max + 1)));
+        CHECK(ring.reserve(static_cast<uint32_t>(max + 1)) == nullptr);
+        CHECK(ring.empty());
+
+        CHECK(ring.write(0, 0, 7, in.data(), static_cast<uint32_t>(max)));
+        RingSlot hdr;
+        const int64_t n = ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size()));
+        CHECK(n == static_cast<int64_t>(max));
+        CHECK(hdr.span == RING_MAX_SPAN);
+        CHECK(intact(out.data(), 7, static_cast<uint32_t>(max)));
+    }
+    unlink(path);
+}
+
+// ----------------------------------------------------------------
+static void large_after_pad(RingOverflow overflow) {
+    const char*    path = "test_ring_large.bin";
+    const uint32_t CAP  = 64;
+    {
+        RingBuffer ring(path, CAP, RingMode::VARIABLE, RingOpen::CREATE,
+                        platform::PageHint::SMALL, overflow);
+        const uint32_t max = static_cast<uint32_t>(ring.max_record());
+        CHECK(max == (CAP / 2 - 1) * sizeof(RingSlot) + RING_INLINE_BYTES);
+
+        std::vector<uint8_t> in, out(CAP * sizeof(RingSlot));
+        auto put = [&](uint32_t id, uint32_t len) {
+            fill(in, id, len);
+            return overflow == RingOverflow::OVERWRITE
+                ? (ring.write_overwrite(id, 0, id, in.data(), len), true)
+                : ring.write(id, 0, id, in.data(), len);
+        };
+
+        // write_idx em 41 (nao alinhado): o proximo grande leva PAD
+        uint32_t id = 0;
+        for (; id < 41; ++id) CHECK(put(id, 8));
+        RingSlot hdr;
+        for (uint32_t i = 0; i < 41; ++i) CHECK(ring.read(hdr));
+        CHECK(ring.empty());
+
+        // Mais que metade do anel: recusado, anel intacto
+        fill(in, 99, max + 1);
+        if (overflow == RingOverflow::OVERWRITE)
+            CHECK(!ring.write_overwrite(99, 0, 99, in.data(), max + 1));
+        else
+            CHECK(!ring.write(99, 0, 99, in.data(), max + 1));
+        CHECK(ring.empty());
+
+        // max_record() no anel vazio: PAD de 23 + 32 slots
+        CHECK(put(id, max));
+        CHECK(ring.size() == 23 + CAP / 2);
+        int64_t n = ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size()));
+        CHECK(n == static_cast<int64_t>(max));
+        CHECK(hdr.packet_id == id);
+        CHECK(intact(out.data(), id, max));
+        CHECK(ring.empty());
+        ++id;
+
+        // Anel com dados e write_idx de novo perto do fim
+        for (uint32_t k = 0; k < 10; ++k, ++id) CHECK(put(id, 8));
+        const uint32_t first_small = id - 10;
+        CHECK(ring.size() == 10);
+        fill(in, id, max);
+        if (overflow == RingOverflow::OVERWRITE) {
+            // 10 + 32 slots cabem; o seguinte descarta os antigos
+            (void)ring.write_overwrite(id, 0, id, in.data(), max);
+            ++id;
+            fill(in, id, max);
+            CHECK(ring.write_overwrite(id, 0, id, in.data(), max));
+            CHECK(ring.size() <= CAP);
+            uint32_t last = 0, got = 0;
+            while ((n = ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size()))) >= 0) {
+                CHECK(hdr.packet_id >= first_small);
+                CHECK(intact(out.data(), hdr.packet_id, static_cast<uint32_t>(n)));
+                last = hdr.packet_id;
+                ++got;
+            }
+            CHECK(last == id);
+            CHECK(got >= 1);
+        } else {
+            CHECK(ring.write(id, 0, id, in.data(), max));
+            ++id;
+            CHECK(!ring.write(id, 0, id, in.data(), max));   // cheio: recusa
+            for (uint32_t k = 0; k < 10; ++k) {
+                CHECK(ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size())) == 8);
+                CHECK(hdr.packet_id == first_small + k);
+            }
+            n = ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size()));
+            CHECK(n == static_cast<int64_t>(max));
+            CHECK(hdr.packet_id == id - 1);
+            CHECK(intact(out.data(), id - 1, max));
+        }
+        CHECK(ring.empty());
+    }
+    unlink(path);
+}
+
+// ----------------------------------------------------------------
+static void torn_write_recovery() {
+    const char*    path    = "test_ring_torn.bin";
+    const uint32_t RECORDS = 20;
+    const uint32_t LEN     = 90;    // 2 slots por registro (32 + 64)
+    const uint32_t READ    = 5;
+    const uint32_t TORN    = 10;
+    unlink(path);
+    {
+        RingBuffer ring(path, 256, RingMode::VARIABLE, RingOpen::RECOVER);
+        CHECK(!ring.recovery().reopened);
+        std::vector<uint8_t> in;
+        for (uint32_t id = 0; id < RECORDS; ++id) {
+            fill(in, id, LEN);
+            CHECK(ring.write(id, 0, id, in.data(), LEN));
+        }
+        RingSlot hdr;
+        for (uint32_t i = 0; i < READ; ++i) CHECK(ring.read(hdr));
+    }
+
+    // Escrita interrompida no meio do payload do registro TORN
+    {
+        const int fd = open(path, O_RDWR);
+        CHECK(fd >= 0);
+        const off_t at = static_cast<off_t>(RING_HEADER_BYTES + TORN * 2 * sizeof(RingSlot)
+                                            + offsetof(RingSlot, payload) + RING_SEAL_BYTES + 40);
+        const uint8_t junk = static_cast<uint8_t>(~pattern(TORN, 40));
+        CHECK(pwrite(fd, &junk, 1, at) == 1);
+        close(fd);
+    }
+
+    {
+        RingBuffer ring(path, 256, RingMode::VARIABLE, RingOpen::RECOVER);
+        const RingRecovery& rec = ring.recovery();
+        CHECK(rec.reopened);
+        CHECK(rec.records == RECORDS - READ - 1);
+        CHECK(rec.slots_dropped == 2);
+
+        std::vector<uint8_t> out(LEN);
+        RingSlot hdr;
+        uint32_t expect = READ;
+        while (ring.read_record(hdr, out.data(), LEN) >= 0) {
+            if (expect == TORN) ++expect;
+            CHECK(hdr.packet_id == expect);
+            CHECK(hdr.payload_len == LEN);
+            CHECK(intact(out.data(), expect, LEN));
+            ++expect;
+        }
+        CHECK(expect == RECORDS);
+    }
+    unlink(path);
+}
+
+// ----------------------------------------------------------------
+static void batch_over_pad() {
+    const char*    path  = "test_ring_batch.bin";
+    const uint32_t SMALL = 30;     // 2 slots cada: write_idx em 60
+    const uint32_t LEN   = 90;
+    const uint32_t BIG   = 480;    // 8 slots: PAD de 4 em 60
+    unlink(path);
+    {
+        RingBuffer ring(path, 64, RingMode::VARIABLE, RingOpen::RECOVER);
+        std::vector<uint8_t> in;
+        for (uint32_t id = 0; id < SMALL; ++id) {
+            fill(in, id, LEN);
+            CHECK(ring.write(id, 0, id, in.data(), LEN));
+        }
+        RingSlot hdr;
+        for (uint32_t i = 0; i + 1 < SMALL; ++i) CHECK(ring.read(hdr));
+        fill(in, SMALL, BIG);
+        CHECK(ring.write(SMALL, 0, SMALL, in.data(), BIG));
+    }
+
+    // Registro depois do PAD corrompido: a reabertura termina o anel
+    // logo apos o PAD
+    {
+        const int fd = open(path, O_RDWR);
+        CHECK(fd >= 0);
+        const off_t at = static_cast<off_t>(RING_HEADER_BYTES + offsetof(RingSlot, payload)
+                                            + RING_SEAL_BYTES + 40);
+        const uint8_t junk = static_cast<uint8_t>(~pattern(SMALL, 40));
+        CHECK(pwrite(fd, &junk, 1, at) == 1);
+        close(fd);
+    }
+
+    {
+        RingBuffer ring(path, 64, RingMode::VARIABLE, RingOpen::RECOVER);
+        CHECK(ring.recovery().records == 1);
+        RingSlot out[8];
+        // Le o ultimo pequeno; o consumidor guarda write_idx = fim do PAD
+        CHECK(ring.read_batch(out, 1) == 1);
+        CHECK(out[0].packet_id == SMALL - 1);
+
+        std::vector<uint8_t> in;
+        fill(in, 100, 8);
+        CHECK(ring.write(100, 0, 100, in.data(), 8));
+        CHECK(ring.read_batch(out, 8) == 1);
+        CHECK(out[0].packet_id == 100);
+        CHECK(ring.read_batch(out, 8) == 0);
+        CHECK(ring.empty());
+    }
+    unlink(path);
+}
+
+// ----------------------------------------------------------------
+static void concurrent(RingOverflow overflow) {
+    const char*    path  = "test_ring_threads.bin";
+    const uint32_t TOTAL = 200000;
+    auto len_of = [](uint32_t id) { return (id * 53u) % 300u + 1u; };
+    {
+        RingBuffer ring(path, 256, RingMode::VARIABLE, RingOpen::CREATE,
+                        platform::PageHint::SMALL, overflow);
+        CHECK(ring.overwrites() == (overflow == RingOverflow::OVERWRITE));
+        std::atomic<bool> done{false};
+
+        std::thread producer([&] {
+            std::vector<uint8_t> in;
+            for (uint32_t id = 0; id < TOTAL; ++id) {
+                fill(in, id, len_of(id));
+                if (overflow == RingOverflow::OVERWRITE) {
+                    (void)ring.write_overwrite(id, 0, id, in.data(), len_of(id));
+                    continue;
+                }
+                while (!ring.write(id, 0, id, in.data(), len_of(id))) sched_yield();
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        std::vector<uint8_t> out(ring.max_record());
+        uint64_t got = 0;
+        int64_t  last = -1;
+        for (;;) {
+            RingSlot hdr;
+            const int64_t n = ring.read_record(hdr, out.data(), static_cast<uint32_t>(out.size()));
+            if (n < 0) {
+                if (done.load(std::memory_order_acquire) && ring.empty()) break;
+                sched_yield();
+                continue;
+            }
+            const uint32_t id = hdr.packet_id;
+            if (overflow == RingOverflow::REJECT) CHECK(id == got);
+            CHECK(static_cast<int64_t>(id) > last);
+            CHECK(hdr.payload_len == len_of(id));
+            CHECK(intact(out.data(), id, static_cast<uint32_t>(n)));
+            last = id;
+            ++got;
+        }
+        producer.join();
+        if (overflow == RingOverflow::REJECT) CHECK(got == TOTAL);
+        CHECK(last == TOTAL - 1);
+    }
+    unlink(path);
+}
+
+int main() {
+    variable_wrap();
+    fixed_inline(RingOpen::CREATE, 40);
+    fixed_inline(RingOpen::RECOVER, 32);
+    span_limit();
+    large_after_pad(RingOverflow::REJECT);
+    large_after_pad(RingOverflow::OVERWRITE);
+    torn_write_recovery();
+    batch_over_pad();
+    concurrent(RingOverflow::REJECT);
+    concurrent(RingOverflow::OVERWRITE);
+    std::printf("test_ring_buffer: %s (%d falhas)\n", g_failures ? "FALHOU" : "OK", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+// Layer: L0 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// test_segmented_arena.cpp - SegmentedArena e WideHandle
+// ================================================================
+//
+// 1. Alocacao que cruzaria o fim do segmento vai inteira para o
+//    seguinte, e o segmento novo e mapeado no 1o uso.
+// 2. Offsets globais acima de 4GB: WideHandle::get_ptr resolve
+//    pelo segmento e o valor gravado volta intacto.
+// 3. Tipos super-alinhados (alignas 64 e 256) depois de alocacoes
+//    de 16 bytes saem alinhados.
+//
+// Segmentos sem populate: so as paginas tocadas custam memoria.
+// Retorna 0 se tudo confere; imprime cada falha.
+// ================================================================
+
+#include "core/sys/segmented_arena.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+using namespace petronilho;
+
+static int g_failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { \
+    std::printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); ++g_failures; } } while (0)
+
+struct alignas(64)  Line64  { uint64_t v[8]; };
+struct alignas(256) Block256 { uint64_t v[4]; };
+
+template<typename T>
+static uint64_t global_offset(const sys::SegmentedArena& a, const sys::WideHandle<T>& h) {
+    return uint64_t(h.segment()) * a.segment_bytes() + h.offset();
+}
+
+// ----------------------------------------------------------------
+static void segment_boundary() {
+    sys::SegmentedArena arena(platform::PAGE_2M);
+    const size_t SEG  = arena.segment_bytes();
+    const size_t PART = SEG / 2 + 4096;   // dois nao cabem num segmento
+
+    auto a = arena.allocate<uint8_t>(PART);
+    auto b = arena.allocate<uint8_t>(PART);
+    CHECK(!a.is_null() && !b.is_null());
+    CHECK(a.segment() == 0 && a.offset() == 0);
+    CHECK(b.segment() == 1);
+    CHECK(b.offset() + PART <= SEG);
+    CHECK(arena.segments() == 2);
+
+    std::memset(a.get_ptr(), 0xAA, PART);
+    std::memset(b.get_ptr(), 0xBB, PART);
+    CHECK(a.get_ptr()[PART - 1] == 0xAA);
+    CHECK(b.get_ptr()[0] == 0xBB);
+
+    // Maior que um segmento: nunca cabe
+    CHECK(arena.allocate<uint8_t>(SEG + 1).is_null());
+}
+
+// ----------------------------------------------------------------
+static void above_4gb() {
+    constexpr size_t SEG = size_t(1) << 30;
+    sys::SegmentedArena arena(SEG, platform::PageHint::SMALL, 8);
+    CHECK(arena.segment_bytes() == SEG);
+
+    // 4 segmentos inteiros: o proximo offset global e 4GB
+    for (uint32_t s = 0; s < 4; ++s) {
+        auto h = arena.allocate<uint8_t>(SEG);
+        CHECK(!h.is_null());
+        CHECK(h.segment() == s);
+        if (!h.is_null()) h.get_ptr()[SEG - 1] = static_cast<uint8_t>(s);
+    }
+
+    auto h = arena.allocate<uint64_t>(4);
+    CHECK(!h.is_null());
+    CHECK(h.segment() == 4);
+    CHECK(global_offset(arena, h) >= (uint64_t(4) << 30));
+    if (!h.is_null()) {
+        for (uint64_t i = 0; i < 4; ++i) h.get_ptr()[i] = 0x0123456789ABCDEFull + i;
+        for (uint64_t i = 0; i < 4; ++i) CHECK(h.get_ptr()[i] == 0x0123456789ABCDEFull + i);
+    }
+    CHECK(arena.used() > (uint64_t(4) << 30));
+
+    // Handle copiado resolve para o mesmo endereco
+    const sys::WideHandle<uint64_t> copy = h;
+    CHECK(copy.get_ptr() == h.get_ptr());
+}
+
+// ----------------------------------------------------------------
+static void over_aligned() {
+    sys::SegmentedArena arena(platform::PAGE_2M);
+    for (uint32_t i = 0; i < 64; ++i) {
+        auto small = arena.allocate<uint8_t>(16);
+        CHECK(!small.is_null());
+
+        auto line = arena.allocate<Line64>();
+        CHECK(!line.is_null());
+        CHECK(reinterpret_cast<uintptr_t>(line.get_ptr()) % alignof(Line64) == 0);
+        CHECK(line.offset() % alignof(Line64) == 0);
+
+        auto blk = arena.allocate<Block256>(i % 3 + 1);
+        CHECK(!blk.is_null());
+        CHECK(reinterpret_cast<uintptr_t>(blk.get_ptr()) % alignof(Block256) == 0);
+
+        // Nenhuma se sobrepoe a anterior
+        CHECK(global_offset(arena, line) >= global_offset(arena, small) + 16);
+        CHECK(global_offset(arena, blk) >= global_offset(arena, line) + sizeof(Line64));
+        std::memset(small.get_ptr(), 0x11, 16);
+        std::memset(line.get_ptr(), 0x22, sizeof(Line64));
+        CHECK(small.get_ptr()[15] == 0x11);
+    }
+}
+
+int main() {
+    segment_boundary();
+    above_4gb();
+    over_aligned();
+    std::printf("test_segmented_arena: %s (%d falhas)\n", g_failures ? "FALHOU" : "OK", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -1,22 +1,301 @@
+// Layer: L3 | Version: 2.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// net_stress_gen.cpp - Gerador de Carga UDP Multi-thread
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// N threads, cada uma com seu socket (porta de origem propria,
+// espalha no SO_REUSEPORT), enviam lotes com sendmmsg. Cada
+// datagrama comeca com um ProbeHeader (probe_header.hpp):
+// stream, seq, TSC de envio e TSC agendado.
+//
+// PACING POR TSC:
+// A taxa alvo vira um intervalo em ciclos por thread. O agendador
+// calcula o instante ideal de cada pacote (intended_tsc) e a
+// thread junta no lote todos os pacotes ja vencidos, ate --batch.
+// Atraso do gerador aparece como send_tsc - intended_tsc, e nao
+// como taxa menor escondida (coordinated omission).
+// --rate 0: sem pacing, vazao maxima.
+//
+// PERFIS:
+//   --size 1472              tamanho fixo
+//   --size uniform:64:1472   uniforme no intervalo
+//   --size imix              64/576/1472 na proporcao 7:4:1
+//   --burst ON_US:OFF_US     rajadas: envia ON_US, silencia OFF_US
+//                            (--rate vale dentro da rajada)
+//
+// ALGORITMO: Agendamento por Relogio Virtual
+// BASE TEORICA: Cormen Cap.17 - Analise Amortizada
+// O custo do sendmmsg e dividido pelo lote; o relogio virtual
+// (intended_tsc += intervalo) nunca acumula erro de arredondamento
+// do relogio real.
+//
+// Uso: net_stress_gen [--dst IP:PORTA] [--threads N] [--rate PPS]
+//                     [--batch B] [--size ...] [--burst ON:OFF]
+//                     [--seconds S]
+// ================================================================
+
+#include "core/sys/probe_header.hpp"
+#include "core/sys/telemetry.hpp"
 #include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <cstdio>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 
-int main() {
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    sockaddr_in servaddr{};
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_port = htons(9999);
-    servaddr.sin_addr.s_addr = inet_addr("127.0.0.1");
-    char payload[1472];
-    std::memset(payload, 'P', sizeof(payload));
-    
-    std::cout << "[STRESSOR] Iniciando flood UDP..." << std::endl;
-    while (true) {
-        sendto(sockfd, payload, sizeof(payload), 0, (const struct sockaddr *)&servaddr, sizeof(servaddr));
+using namespace petronilho;
+
+static constexpr uint32_t MAX_BATCH   = 1024;
+static constexpr uint32_t MAX_PAYLOAD = 1472;
+
+enum class SizeMode : uint8_t { FIXED, UNIFORM, IMIX };
+
+struct GenConfig {
+    const char* ip        = "127.0.0.1";
+    uint16_t    port      = 9999;
+    uint32_t    threads   = 1;
+    uint64_t    rate      = 0;      // pps total; 0 = sem pacing
+    uint32_t    batch     = 32;
+    SizeMode    size_mode = SizeMode::FIXED;
+    uint32_t    size_min  = MAX_PAYLOAD;
+    uint32_t    size_max  = MAX_PAYLOAD;
+    uint64_t    burst_on_us  = 0;   // 0 = sem rajada
+    uint64_t    burst_off_us = 0;
+    uint32_t    seconds   = 0;      // 0 = para sempre
+};
+
+// Contadores por thread, cada um na sua cache line
+struct alignas(64) GenCounters {
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> syscalls{0};
+    std::atomic<uint64_t> lag_cycles{0};  // soma de send - intended
+};
+
+static std::atomic<bool> g_running{true};
+
+// xorshift64: barato e sem estado global
+static inline uint64_t next_random(uint64_t& s) noexcept {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+}
+
+static inline uint32_t pick_size(const GenConfig& cfg, uint64_t& rng) noexcept {
+    switch (cfg.size_mode) {
+    case SizeMode::UNIFORM:
+        return cfg.size_min + (uint32_t)(next_random(rng) % (cfg.size_max - cfg.size_min + 1));
+    case SizeMode::IMIX: {
+        const uint32_t r = (uint32_t)(next_random(rng) % 12);
+        return r < 7 ? 64 : (r < 11 ? 576 : 1472);
+    }
+    default:
+        return cfg.size_min;
+    }
+}
+
+// ================================================================
+// Agendador: instante ideal do proximo pacote, com rajadas
+// ================================================================
+struct Schedule {
+    uint64_t interval;   // ciclos entre pacotes (0 = sem pacing)
+    uint64_t on_cycles;  // duracao da rajada (0 = continuo)
+    uint64_t period;     // on + off
+    uint64_t origin;
+    uint64_t next;
+
+    uint64_t advance() noexcept {
+        const uint64_t t = next;
+        next += interval;
+        if (on_cycles) {
+            // Caiu no silencio: pula para o inicio da proxima rajada
+            const uint64_t phase = (next - origin) % period;
+            if (phase >= on_cycles) next += period - phase;
+        }
+        return t;
+    }
+};
+
+static void sender_thread(uint16_t stream, GenConfig cfg, GenCounters* counters) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in dst{};
+    dst.sin_family      = AF_INET;
+    dst.sin_port        = htons(cfg.port);
+    dst.sin_addr.s_addr = inet_addr(cfg.ip);
+    if (fd < 0 || connect(fd, (const sockaddr*)&dst, sizeof(dst)) < 0) {
+        perror("[STRESSOR] socket");
+        return;
+    }
+
+    std::vector<uint8_t> buffers((size_t)cfg.batch * MAX_PAYLOAD, 'P');
+    std::vector<iovec>   iov(cfg.batch);
+    std::vector<mmsghdr> msgs(cfg.batch);
+    for (uint32_t i = 0; i < cfg.batch; ++i) {
+        iov[i].iov_base = &buffers[(size_t)i * MAX_PAYLOAD];
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_iov    = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
     }
+
+    const double   tpn      = sys::tsc_per_ns();
+    const uint64_t per_thr  = cfg.rate / cfg.threads;
+    Schedule sched{};
+    sched.interval  = per_thr ? (uint64_t)(1e9 * tpn / (double)per_thr) : 0;
+    sched.on_cycles = (uint64_t)(cfg.burst_on_us * 1000 * tpn);
+    sched.period    = sched.on_cycles + (uint64_t)(cfg.burst_off_us * 1000 * tpn);
+    sched.origin    = sys::read_tsc();
+    sched.next      = sched.origin;
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)stream << 32 | 1);
+    uint64_t seq = 0;
+
+    while (g_running.load(std::memory_order_relaxed)) {
+        // Junta os pacotes vencidos (todos, sem pacing) ate o lote
+        uint64_t now = sys::read_tsc();
+        if (sched.interval && sched.next > now) { _mm_pause(); continue; }
+
+        uint32_t n = 0;
+        uint64_t intended[MAX_BATCH];
+        while (n < cfg.batch && (!sched.interval || sched.next <= now)) {
+            intended[n] = sched.interval ? sched.advance() : now;
+            iov[n].iov_len = pick_size(cfg, rng);
+            ++n;
+        }
+
+        // Carimbo de envio o mais tarde possivel
+        now = sys::read_tsc();
+        uint64_t lag = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            net::ProbeHeader h;
+            h.magic        = net::PROBE_MAGIC;
+            h.stream       = stream;
+            h.flags        = 0;
+            h.seq          = seq + i;
+            h.send_tsc     = now;
+            h.intended_tsc = intended[i];
+            std::memcpy(iov[i].iov_base, &h, sizeof(h));
+            lag += now - intended[i];
+        }
+
+        const int sent = sendmmsg(fd, msgs.data(), n, 0);
+        if (sent <= 0) continue;
+
+        // Os nao enviados saem no proximo lote com o mesmo seq
+        uint64_t bytes = 0;
+        for (int i = 0; i < sent; ++i) bytes += iov[i].iov_len;
+        seq += (uint64_t)sent;
+        if (sched.interval && (uint32_t)sent < n)
+            sched.next = intended[sent];
+
+        counters->packets.fetch_add((uint64_t)sent, std::memory_order_relaxed);
+        counters->bytes.fetch_add(bytes, std::memory_order_relaxed);
+        counters->syscalls.fetch_add(1, std::memory_order_relaxed);
+        counters->lag_cycles.fetch_add(lag, std::memory_order_relaxed);
+    }
+    close(fd);
+}
+
+static bool parse_args(int argc, char** argv, GenConfig& cfg) {
+    static char ip_buf[64];
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* k = argv[i];
+        const char* v = argv[i + 1];
+        if (!std::strcmp(k, "--dst")) {
+            std::snprintf(ip_buf, sizeof(ip_buf), "%s", v);
+            char* colon = std::strchr(ip_buf, ':');
+            if (colon) { *colon = 0; cfg.port = (uint16_t)std::atoi(colon + 1); }
+            cfg.ip = ip_buf;
+        } else if (!std::strcmp(k, "--threads")) {
+            cfg.threads = (uint32_t)std::atoi(v);
+        } else if (!std::strcmp(k, "--rate")) {
+            cfg.rate = (uint64_t)std::atoll(v);
+        } else if (!std::strcmp(k, "--batch")) {
+            cfg.batch = (uint32_t)std::atoi(v);
+        } else if (!std::strcmp(k, "--seconds")) {
+            cfg.seconds = (uint32_t)std::atoi(v);
+        } else if (!std::strcmp(k, "--size")) {
+            if (!std::strcmp(v, "imix")) {
+                cfg.size_mode = SizeMode::IMIX;
+            } else if (!std::strncmp(v, "uniform:", 8)) {
+                cfg.size_mode = SizeMode::UNIFORM;
+                if (std::sscanf(v + 8, "%u:%u", &cfg.size_min, &cfg.size_max) != 2) return false;
+            } else {
+                cfg.size_mode = SizeMode::FIXED;
+                cfg.size_min = cfg.size_max = (uint32_t)std::atoi(v);
+            }
+        } else if (!std::strcmp(k, "--burst")) {
+            unsigned long long on = 0, off = 0;
+            if (std::sscanf(v, "%llu:%llu", &on, &off) != 2) return false;
+            cfg.burst_on_us  = on;
+            cfg.burst_off_us = off;
+        } else {
+            return false;
+        }
+    }
+
+    const uint32_t min_size = sizeof(net::ProbeHeader);
+    if (cfg.threads == 0) cfg.threads = 1;
+    if (cfg.batch == 0 || cfg.batch > MAX_BATCH) cfg.batch = 32;
+    if (cfg.size_min < min_size) cfg.size_min = min_size;
+    if (cfg.size_max > MAX_PAYLOAD) cfg.size_max = MAX_PAYLOAD;
+    if (cfg.size_max < cfg.size_min) cfg.size_max = cfg.size_min;
+    if (cfg.burst_on_us == 0) cfg.burst_off_us = 0;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    GenConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        std::cerr << "Uso: net_stress_gen [--dst IP:PORTA] [--threads N] [--rate PPS]"
+                     " [--batch B] [--size N|uniform:MIN:MAX|imix]"
+                     " [--burst ON_US:OFF_US] [--seconds S]" << std::endl;
+        return 1;
+    }
+
+    const double tpn = sys::tsc_per_ns();
+    std::cout << "[STRESSOR] " << cfg.ip << ":" << cfg.port
+              << " | Threads: " << cfg.threads
+              << " | Taxa: " << (cfg.rate ? std::to_string(cfg.rate) + " pps" : std::string("maxima"))
+              << " | Lote sendmmsg: " << cfg.batch
+              << " | TSC: " << std::fixed << std::setprecision(3) << tpn << " ciclos/ns"
+              << std::endl;
+
+    std::vector<GenCounters> counters(cfg.threads);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < cfg.threads; ++t)
+        threads.emplace_back(sender_thread, (uint16_t)t, cfg, &counters[t]);
+
+    uint64_t last_pkts = 0, last_bytes = 0;
+    for (uint32_t s = 1; cfg.seconds == 0 || s <= cfg.seconds; ++s) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        uint64_t pkts = 0, bytes = 0, calls = 0, lag = 0;
+        for (auto& c : counters) {
+            pkts  += c.packets.load(std::memory_order_relaxed);
+            bytes += c.bytes.load(std::memory_order_relaxed);
+            calls += c.syscalls.load(std::memory_order_relaxed);
+            lag   += c.lag_cycles.load(std::memory_order_relaxed);
+        }
+        std::cout << "[STRESSOR] " << s << "s | "
+                  << std::setprecision(3) << (pkts - last_pkts) / 1e6 << " Mpps | "
+                  << std::setprecision(2) << (bytes - last_bytes) * 8 / 1e9 << " Gbps | "
+                  << "Pkt/syscall: " << (calls ? (double)pkts / calls : 0.0) << " | "
+                  << "Atraso medio do pacing: "
+                  << (pkts ? lag / tpn / pkts / 1000.0 : 0.0) << " us" << std::endl;
+        last_pkts  = pkts;
+        last_bytes = bytes;
+    }
+
+    g_running = false;
+    for (auto& t : threads) t.join();
     return 0;
 }
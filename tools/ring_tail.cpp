@@ -0,0 +1,78 @@
+// Layer: L3 | Version: 1.0.0 | Author: Fabio Petronilho de Oliveira
+//
+// ================================================================
+// ring_tail.cpp - Consumidor Externo do RingBuffer
+// ================================================================
+//
+// O QUE ESSE CODIGO FAZ:
+// Anexa a um RingBuffer criado por outro processo (o ingestor
+// grava ring_audit.bin) e consome os registros direto do
+// mapeamento, sem socket no meio: peek() devolve o registro no
+// lugar, release() avanca read_idx no cabecalho compartilhado.
+// A cada segundo imprime registros/s, MB/s de payload, o backlog
+// do anel e os registros perdidos para write_overwrite.
+//
+// O ingestor recria o arquivo ao iniciar (O_TRUNC): inicie o
+// ring_tail depois dele.
+//
+// Uso: ring_tail [arquivo] [segundos]
+// ================================================================
+
+#include "core/sys/ring_buffer.hpp"
+#include "core/platform/platform_detect.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <sched.h>
+
+int main(int argc, char** argv) {
+    const char*    filename = (argc > 1) ? argv[1] : "ring_audit.bin";
+    const uint32_t seconds  = (argc > 2) ? (uint32_t)std::atoi(argv[2]) : 10;
+
+    try {
+        petronilho::RingBuffer ring(filename, petronilho::RING_ATTACH);
+        std::cout << "[RING TAIL] " << filename << " | " << ring.capacity() << " slots | modo "
+                  << (ring.mode() == petronilho::RingMode::VARIABLE ? "VARIABLE" : "FIXED")
+                  << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+
+        uint64_t records = 0, bytes = 0, lost = 0;
+        uint64_t total_records = 0, total_bytes = 0, total_lost = 0;
+        uint32_t idle = 0, iter = 0;
+
+        auto tick = std::chrono::steady_clock::now();
+        for (uint32_t s = 0; s < seconds;) {
+            const petronilho::RingSlot* rec = ring.peek();
+            if (rec) {
+                const uint32_t len = rec->payload_len;
+                if (ring.release()) { ++records; bytes += len; }
+                else                ++lost;
+                idle = 0;
+                // Relogio a cada 4096 registros sob carga continua
+                if ((++iter & 4095) != 0) continue;
+            } else {
+                _mm_pause();
+                if ((++idle & 1023) == 0) sched_yield();
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now - tick < std::chrono::seconds(1)) continue;
+            tick = now;
+            ++s;
+            std::cout << "  t=" << std::setw(3) << s << "s | "
+                      << std::setw(10) << records << " reg/s | "
+                      << std::setw(8) << bytes / 1e6 << " MB/s | backlog "
+                      << std::setw(8) << ring.size() << " slots | sobrescritos "
+                      << lost << std::endl;
+            total_records += records; total_bytes += bytes; total_lost += lost;
+            records = bytes = lost = 0;
+        }
+        std::cout << "[RING TAIL] total: " << total_records << " registros | "
+                  << total_bytes / 1e6 << " MB | sobrescritos " << total_lost << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}